@@ -104,8 +104,14 @@
 #    define ADC_RESOLUTION ADC_CFGR1_RES_10BIT
 #endif
 
+// Samples for adc_read_group(), all channels times the oversampling depth
+#ifndef ADC_GROUP_BUFFER_SIZE
+#    define ADC_GROUP_BUFFER_SIZE 32
+#endif
+
 static ADCConfig   adcCfg = {};
 static adcsample_t sampleBuffer[ADC_NUM_CHANNELS * ADC_BUFFER_DEPTH];
+static adcsample_t groupBuffer[ADC_GROUP_BUFFER_SIZE];
 
 // Initialize to max number of ADCs, set to empty object to initialize all to false.
 static bool adcInitialized[ADC_COUNT] = {};
@@ -274,3 +280,84 @@ int16_t adc_read(adc_mux mux) {
     return *sampleBuffer;
 #endif
 }
+
+bool adc_read_group(const adc_mux *muxes, uint8_t count, uint8_t depth, uint32_t *sums) {
+    if (count == 0 || count > 16 || depth == 0 || count * depth > ADC_GROUP_BUFFER_SIZE) {
+        return false;
+    }
+
+    ADCConversionGroup group = adcConversionGroup;
+    group.num_channels       = count;
+#if defined(USE_ADCV1)
+    // channels are converted in ascending order, not in the order they were given
+    group.chselr = 0;
+#elif defined(USE_ADCV2)
+    group.sqr1 = ADC_SQR1_NUM_CH(count);
+    group.sqr2 = 0;
+    group.sqr3 = 0;
+#else
+    group.sqr[0] = ADC_SQR1_NUM_CH(count);
+    group.sqr[1] = 0;
+    group.sqr[2] = 0;
+    group.sqr[3] = 0;
+#endif
+    for (uint8_t i = 0; i < count; i++) {
+        // A scan group runs on a single ADC
+        if (muxes[i].adc != muxes[0].adc) {
+            return false;
+        }
+        uint32_t input = muxes[i].input;
+#if defined(USE_ADCV1)
+        if (group.chselr & (1 << input)) {
+            return false;
+        }
+        group.chselr |= 1 << input;
+#elif defined(USE_ADCV2)
+        // 5 bit sequence slots, SQ1-6 in SQR3, SQ7-12 in SQR2, SQ13-16 in SQR1
+        if (i < 6) {
+            group.sqr3 |= input << (5 * i);
+        } else if (i < 12) {
+            group.sqr2 |= input << (5 * (i - 6));
+        } else {
+            group.sqr1 |= input << (5 * (i - 12));
+        }
+#else
+        // 6 bit sequence slots, SQ1-4 in SQR1 after the length field, then five per register
+        uint8_t slot = i + 1;
+        group.sqr[slot / 5] |= input << (6 * (slot % 5));
+#endif
+    }
+
+    ADCDriver *targetDriver = intToADCDriver(muxes[0].adc);
+    if (!targetDriver) {
+        return false;
+    }
+
+    manageAdcInitializationDriver(muxes[0].adc, targetDriver);
+    // One DMA transfer for every channel and every oversample
+    if (adcConvert(targetDriver, &group, &groupBuffer[0], depth) != MSG_OK) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t column = i;
+#if defined(USE_ADCV1)
+        column = 0;
+        for (uint8_t j = 0; j < count; j++) {
+            if (muxes[j].input < muxes[i].input) {
+                column++;
+            }
+        }
+#endif
+        uint32_t sum = 0;
+        for (uint8_t n = 0; n < depth; n++) {
+            sum += groupBuffer[n * count + column];
+        }
+#ifdef USE_ADCV2
+        // fake 12-bit -> N-bit scale
+        sum >>= 12 - ADC_RESOLUTION;
+#endif
+        sums[i] = sum;
+    }
+    return true;
+}
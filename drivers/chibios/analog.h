@@ -36,6 +36,11 @@ adc_mux pinToMux(pin_t pin);
 
 int16_t adc_read(adc_mux mux);
 
+/* Converts every mux once per depth in a single scan group, and stores the sum of each mux's samples in sums.
+ * All muxes must be on the same ADC. Returns false if the group cannot be converted in one go.
+ */
+bool adc_read_group(const adc_mux *muxes, uint8_t count, uint8_t depth, uint32_t *sums);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,9 @@ void DRV_write(uint8_t drv_register, uint8_t settings) {
     i2c_transmit(DRV2605L_BASE_ADDRESS << 1, DRV2605L_transfer_buffer, 2, 100);
 }
 
+// Writes consecutive registers starting at drv_register in one transfer, the DRV2605L auto-increments the address
+void DRV_write_block(uint8_t drv_register, const uint8_t *settings, uint8_t length) { i2c_writeReg(DRV2605L_BASE_ADDRESS << 1, drv_register, settings, length, 100); }
+
 uint8_t DRV_read(uint8_t regaddress) {
     i2c_readReg(DRV2605L_BASE_ADDRESS << 1, regaddress, &DRV2605L_read_register, 1, 100);
 
@@ -64,19 +67,16 @@ void DRV_init(void) {
     FB_SET.Bits.BRAKE_FACTOR = FB_BRAKEFACTOR;
     FB_SET.Bits.LOOP_GAIN    = FB_LOOPGAIN;
     FB_SET.Bits.BEMF_GAIN    = 0; /* auto-calibration populates this field*/
-    DRV_write(DRV_FEEDBACK_CTRL, (uint8_t)FB_SET.Byte);
     DRVREG_CTRL1 C1_SET;
     C1_SET.Bits.C1_DRIVE_TIME    = DRIVE_TIME;
     C1_SET.Bits.C1_AC_COUPLE     = AC_COUPLE;
     C1_SET.Bits.C1_STARTUP_BOOST = STARTUP_BOOST;
-    DRV_write(DRV_CTRL_1, (uint8_t)C1_SET.Byte);
     DRVREG_CTRL2 C2_SET;
     C2_SET.Bits.C2_BIDIR_INPUT   = BIDIR_INPUT;
     C2_SET.Bits.C2_BRAKE_STAB    = BRAKE_STAB;
     C2_SET.Bits.C2_SAMPLE_TIME   = SAMPLE_TIME;
     C2_SET.Bits.C2_BLANKING_TIME = BLANKING_TIME;
     C2_SET.Bits.C2_IDISS_TIME    = IDISS_TIME;
-    DRV_write(DRV_CTRL_2, (uint8_t)C2_SET.Byte);
     DRVREG_CTRL3 C3_SET;
     C3_SET.Bits.C3_LRA_OPEN_LOOP   = LRA_OPEN_LOOP;
     C3_SET.Bits.C3_N_PWM_ANALOG    = N_PWM_ANALOG;
@@ -85,11 +85,12 @@ void DRV_init(void) {
     C3_SET.Bits.C3_SUPPLY_COMP_DIS = SUPPLY_COMP_DIS;
     C3_SET.Bits.C3_ERM_OPEN_LOOP   = ERM_OPEN_LOOP;
     C3_SET.Bits.C3_NG_THRESH       = NG_THRESH;
-    DRV_write(DRV_CTRL_3, (uint8_t)C3_SET.Byte);
     DRVREG_CTRL4 C4_SET;
     C4_SET.Bits.C4_ZC_DET_TIME   = ZC_DET_TIME;
     C4_SET.Bits.C4_AUTO_CAL_TIME = AUTO_CAL_TIME;
-    DRV_write(DRV_CTRL_4, (uint8_t)C4_SET.Byte);
+    // feedback control and control 1-4 are consecutive registers
+    uint8_t control[] = {(uint8_t)FB_SET.Byte, (uint8_t)C1_SET.Byte, (uint8_t)C2_SET.Byte, (uint8_t)C3_SET.Byte, (uint8_t)C4_SET.Byte};
+    DRV_write_block(DRV_FEEDBACK_CTRL, control, sizeof(control));
     DRV_write(DRV_LIB_SELECTION, LIB_SELECTION);
 
     DRV_write(DRV_GO, 0x01);
@@ -99,9 +100,7 @@ void DRV_init(void) {
     DRV_write(DRV_MODE, 0x00);
 
     // Play greeting sequence
-    DRV_write(DRV_GO, 0x00);
-    DRV_write(DRV_WAVEFORM_SEQ_1, DRV_GREETING);
-    DRV_write(DRV_GO, 0x01);
+    DRV_pulse(DRV_GREETING);
 }
 
 void DRV_rtp_init(void) {
@@ -115,6 +114,9 @@ void DRV_amplitude(uint8_t amplitude) { DRV_write(DRV_RTP_INPUT, amplitude); }
 
 void DRV_pulse(uint8_t sequence) {
     DRV_write(DRV_GO, 0x00);
-    DRV_write(DRV_WAVEFORM_SEQ_1, sequence);
-    DRV_write(DRV_GO, 0x01);
+    /* The GO register follows the eight waveform sequencer slots, so the effect, the empty slots that end the
+     * sequence after it, and GO itself go out in a single transfer */
+    uint8_t sequencer[DRV_GO - DRV_WAVEFORM_SEQ_1 + 1] = {sequence};
+    sequencer[DRV_GO - DRV_WAVEFORM_SEQ_1]             = 0x01;
+    DRV_write_block(DRV_WAVEFORM_SEQ_1, sequencer, sizeof(sequencer));
 }
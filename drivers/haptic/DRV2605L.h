@@ -169,6 +169,7 @@
 
 void    DRV_init(void);
 void    DRV_write(const uint8_t drv_register, const uint8_t settings);
+void    DRV_write_block(const uint8_t drv_register, const uint8_t *settings, const uint8_t length);
 uint8_t DRV_read(const uint8_t regaddress);
 void    DRV_rtp_init(void);
 void    DRV_amplitude(const uint8_t amplitude);
@@ -27,6 +27,12 @@
 
 haptic_config_t haptic_config;
 
+// feedback requested by haptic_play, carried out from haptic_task
+static bool haptic_pending = false;
+#if HAPTIC_RATE_LIMIT > 0
+static uint16_t haptic_last_play = 0;
+#endif
+
 void haptic_init(void) {
     debug_enable = 1;  // Debug is ON!
     if (!eeconfig_is_enabled()) {
@@ -59,8 +65,22 @@ void haptic_init(void) {
 }
 
 void haptic_task(void) {
+    if (!haptic_pending) {
+        return;
+    }
+#if HAPTIC_RATE_LIMIT > 0
+    // keep the feedback waiting, rather than dropping it, so a burst of keys still ends with a pulse
+    if (timer_elapsed(haptic_last_play) < HAPTIC_RATE_LIMIT) {
+        return;
+    }
+    haptic_last_play = timer_read();
+#endif
+    haptic_pending = false;
+#ifdef DRV2605L
+    DRV_pulse(haptic_config.mode);
+#endif
 #ifdef SOLENOID_ENABLE
-    solenoid_check();
+    solenoid_fire();
 #endif
 }
 
@@ -280,16 +300,9 @@ void haptic_cont_decrease(void) {
     haptic_set_amplitude(amp);
 }
 
-void haptic_play(void) {
-#ifdef DRV2605L
-    uint8_t play_eff = 0;
-    play_eff         = haptic_config.mode;
-    DRV_pulse(play_eff);
-#endif
-#ifdef SOLENOID_ENABLE
-    solenoid_fire();
-#endif
-}
+/* Only queues the feedback: the I2C transfers and pin changes happen in haptic_task, so keys processed in the same
+ * scan share one pulse and none of it runs while the key events are being handled */
+void haptic_play(void) { haptic_pending = true; }
 
 bool process_haptic(uint16_t keycode, keyrecord_t *record) {
     if (keycode == HPT_ON && record->event.pressed) {
@@ -349,6 +362,7 @@ bool process_haptic(uint16_t keycode, keyrecord_t *record) {
 }
 
 void haptic_shutdown(void) {
+    haptic_pending = false;
 #ifdef SOLENOID_ENABLE
     solenoid_shutdown();
 #endif
@@ -29,6 +29,10 @@
 #ifndef HAPTIC_MODE_DEFAULT
 #    define HAPTIC_MODE_DEFAULT DRV_MODE_DEFAULT
 #endif
+// Minimum time between two feedback pulses in ms, feedback requested sooner is delayed and merged
+#ifndef HAPTIC_RATE_LIMIT
+#    define HAPTIC_RATE_LIMIT 0
+#endif
 
 /* EEPROM config settings */
 typedef union {
@@ -18,11 +18,13 @@
 #include "timer.h"
 #include "solenoid.h"
 #include "haptic.h"
+#include "deferred_exec.h"
 
-bool     solenoid_on      = false;
-bool     solenoid_buzzing = false;
-uint16_t solenoid_start   = 0;
-uint8_t  solenoid_dwell   = SOLENOID_DEFAULT_DWELL;
+bool           solenoid_on      = false;
+bool           solenoid_buzzing = false;
+uint32_t       solenoid_start   = 0;
+uint8_t        solenoid_dwell   = SOLENOID_DEFAULT_DWELL;
+deferred_token solenoid_token   = INVALID_DEFERRED_TOKEN;
 
 extern haptic_config_t haptic_config;
 
@@ -35,47 +37,50 @@ void solenoid_set_buzz(int buzz) { haptic_set_buzz(buzz); }
 void solenoid_set_dwell(uint8_t dwell) { solenoid_dwell = dwell; }
 
 void solenoid_stop(void) {
+    cancel_deferred_exec(solenoid_token);
+    solenoid_token = INVALID_DEFERRED_TOKEN;
     writePinLow(SOLENOID_PIN);
     solenoid_on      = false;
     solenoid_buzzing = false;
 }
 
+// Runs at each edge of the click or buzz, so nothing has to be checked on the scans in between
+static uint32_t solenoid_step(uint32_t trigger_time, void *cb_arg) {
+    uint32_t elapsed = trigger_time - solenoid_start;
+
+    // Check if it's time to finish this solenoid click cycle
+    if (!haptic_config.buzz || elapsed >= solenoid_dwell) {
+        solenoid_token = INVALID_DEFERRED_TOKEN;
+        solenoid_stop();
+        return 0;
+    }
+
+    // Buzz the solenoid on and off until the dwell time is over
+    solenoid_buzzing = !solenoid_buzzing;
+    writePin(SOLENOID_PIN, solenoid_buzzing);
+    uint32_t next = solenoid_buzzing ? SOLENOID_BUZZ_ACTUATED : SOLENOID_BUZZ_NONACTUATED;
+    if (next > solenoid_dwell - elapsed) {
+        next = solenoid_dwell - elapsed;
+    }
+    // returning 0 would cancel the callback and leave the solenoid in its current state
+    return next ? next : 1;
+}
+
 void solenoid_fire(void) {
     if (!haptic_config.buzz && solenoid_on) return;
     if (haptic_config.buzz && solenoid_buzzing) return;
 
+    cancel_deferred_exec(solenoid_token);
     solenoid_on      = true;
     solenoid_buzzing = true;
-    solenoid_start   = timer_read();
+    solenoid_start   = timer_read32();
     writePinHigh(SOLENOID_PIN);
-}
-
-void solenoid_check(void) {
-    uint16_t elapsed = 0;
-
-    if (!solenoid_on) return;
-
-    elapsed = timer_elapsed(solenoid_start);
 
-    // Check if it's time to finish this solenoid click cycle
-    if (elapsed > solenoid_dwell) {
+    uint32_t first = (haptic_config.buzz && SOLENOID_BUZZ_ACTUATED < solenoid_dwell) ? SOLENOID_BUZZ_ACTUATED : solenoid_dwell;
+    solenoid_token = defer_exec(first ? first : 1, solenoid_step, NULL);
+    if (solenoid_token == INVALID_DEFERRED_TOKEN) {
+        // no executor left to end the click, better no click than a solenoid stuck on
         solenoid_stop();
-        return;
-    }
-
-    // Check whether to buzz the solenoid on and off
-    if (haptic_config.buzz) {
-        if ((elapsed % (SOLENOID_BUZZ_ACTUATED + SOLENOID_BUZZ_NONACTUATED)) < SOLENOID_BUZZ_ACTUATED) {
-            if (!solenoid_buzzing) {
-                solenoid_buzzing = true;
-                writePinHigh(SOLENOID_PIN);
-            }
-        } else {
-            if (solenoid_buzzing) {
-                solenoid_buzzing = false;
-                writePinLow(SOLENOID_PIN);
-            }
-        }
     }
 }
 
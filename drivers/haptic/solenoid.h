@@ -58,7 +58,5 @@ void solenoid_set_dwell(uint8_t dwell);
 void solenoid_stop(void);
 void solenoid_fire(void);
 
-void solenoid_check(void);
-
 void solenoid_setup(void);
 void solenoid_shutdown(void);
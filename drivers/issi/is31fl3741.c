@@ -73,9 +73,17 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // buffers and the transfers in IS31FL3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
-bool    g_pwm_buffer_update_required                      = false;
 bool    g_scaling_registers_update_required[DRIVER_COUNT] = {false};
 
+// Each bit flags an 18 byte chunk of the PWM registers (one I2C transfer)
+// whose contents changed since it was last written to the device. PG0 holds
+// chunks 0-9 and PG1 chunks 10-19, so a page without dirty chunks is not
+// even selected.
+#define ISSI_PWM_CHUNK_SIZE 18
+#define ISSI_PWM_CHUNK_COUNT ((ISSI_MAX_LEDS + ISSI_PWM_CHUNK_SIZE - 1) / ISSI_PWM_CHUNK_SIZE)
+#define ISSI_PWM_PAGE_SIZE 180
+uint32_t g_pwm_buffer_dirty_chunks[DRIVER_COUNT] = {0};
+
 uint8_t g_scaling_registers[DRIVER_COUNT][ISSI_MAX_LEDS];
 
 void IS31FL3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
@@ -91,51 +99,51 @@ void IS31FL3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-bool IS31FL3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
-    // unlock the command register and select PG2
-    IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
-    IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM0);
+static bool IS31FL3741_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint32_t chunks) {
+    uint8_t selected_page = 0xFF;
 
-    for (int i = 0; i < 342; i += 18) {
-        if (i == 180) {
-            // unlock the command register and select PG2
+    for (uint8_t chunk = 0; chunk < ISSI_PWM_CHUNK_COUNT; chunk++) {
+        if (!(chunks & ((uint32_t)1 << chunk))) {
+            continue;
+        }
+        uint16_t i    = chunk * ISSI_PWM_CHUNK_SIZE;
+        uint8_t  page = i < ISSI_PWM_PAGE_SIZE ? ISSI_PAGE_PWM0 : ISSI_PAGE_PWM1;
+        // the last chunk is short, as the total number is 351
+        uint8_t len = ISSI_MAX_LEDS - i < ISSI_PWM_CHUNK_SIZE ? ISSI_MAX_LEDS - i : ISSI_PWM_CHUNK_SIZE;
+
+        if (page != selected_page) {
+            // unlock the command register and select PG0/PG1
             IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
-            IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM1);
+            IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, page);
+            selected_page = page;
         }
 
-        g_twi_transfer_buffer[0] = i % 180;
-        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, 18);
+        g_twi_transfer_buffer[0] = i % ISSI_PWM_PAGE_SIZE;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, len);
 
 #if ISSI_PERSISTENCE > 0
         for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, ISSI_TIMEOUT) != 0) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, len + 1, ISSI_TIMEOUT) != 0) {
                 return false;
             }
         }
 #else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, ISSI_TIMEOUT) != 0) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, len + 1, ISSI_TIMEOUT) != 0) {
             return false;
         }
 #endif
     }
 
-    // transfer the left cause the total number is 351
-    g_twi_transfer_buffer[0] = 162;
-    memcpy(g_twi_transfer_buffer + 1, pwm_buffer + 342, 9);
+    return true;
+}
 
-#if ISSI_PERSISTENCE > 0
-    for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, ISSI_TIMEOUT) != 0) {
-            return false;
-        }
-    }
-#else
-    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, ISSI_TIMEOUT) != 0) {
-        return false;
-    }
-#endif
+bool IS31FL3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) { return IS31FL3741_write_pwm_chunks(addr, pwm_buffer, ((uint32_t)1 << ISSI_PWM_CHUNK_COUNT) - 1); }
 
-    return true;
+static inline void IS31FL3741_set_pwm(uint8_t driver, uint16_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty_chunks[driver] |= (uint32_t)1 << (reg / ISSI_PWM_CHUNK_SIZE);
+    }
 }
 
 void IS31FL3741_init(uint8_t addr) {
@@ -169,10 +177,9 @@ void IS31FL3741_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         is31_led led = g_is31_leds[index];
 
-        g_pwm_buffer[led.driver][led.r] = red;
-        g_pwm_buffer[led.driver][led.g] = green;
-        g_pwm_buffer[led.driver][led.b] = blue;
-        g_pwm_buffer_update_required    = true;
+        IS31FL3741_set_pwm(led.driver, led.r, red);
+        IS31FL3741_set_pwm(led.driver, led.g, green);
+        IS31FL3741_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -207,19 +214,19 @@ void IS31FL3741_set_led_control_register(uint8_t index, bool red, bool green, bo
 }
 
 void IS31FL3741_update_pwm_buffers(uint8_t addr1, uint8_t addr2) {
-    if (g_pwm_buffer_update_required) {
-        IS31FL3741_write_pwm_buffer(addr1, g_pwm_buffer[0]);
+    // Keep the chunks dirty if any of the transactions fail, so they are
+    // sent again on the next update.
+    if (g_pwm_buffer_dirty_chunks[0] && !IS31FL3741_write_pwm_chunks(addr1, g_pwm_buffer[0], g_pwm_buffer_dirty_chunks[0])) {
+        return;
     }
 
-    g_pwm_buffer_update_required = false;
+    g_pwm_buffer_dirty_chunks[0] = 0;
 }
 
 void IS31FL3741_set_pwm_buffer(const is31_led *pled, uint8_t red, uint8_t green, uint8_t blue) {
-    g_pwm_buffer[pled->driver][pled->r] = red;
-    g_pwm_buffer[pled->driver][pled->g] = green;
-    g_pwm_buffer[pled->driver][pled->b] = blue;
-
-    g_pwm_buffer_update_required = true;
+    IS31FL3741_set_pwm(pled->driver, pled->r, red);
+    IS31FL3741_set_pwm(pled->driver, pled->g, green);
+    IS31FL3741_set_pwm(pled->driver, pled->b, blue);
 }
 
 void IS31FL3741_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -66,7 +66,7 @@ typedef struct _I2C_slave_buffer_t {
     rgblight_syncinfo_t rgblight_sync;
 #    endif
 #    ifdef ENCODER_ENABLE
-    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+    encoder_sync_t encoder_state[NUMBER_OF_ENCODERS];
 #    endif
 #    ifdef WPM_ENABLE
     uint8_t current_wpm;
@@ -298,7 +298,7 @@ typedef struct _Serial_s2m_buffer_t {
     // TODO: if MATRIX_COLS > 8 change to uint8_t packed_matrix[] for pack/unpack
     matrix_row_t smatrix[ROWS_PER_HAND];
 #    ifdef ENCODER_ENABLE
-    uint8_t      encoder_state[NUMBER_OF_ENCODERS];
+    encoder_sync_t encoder_state[NUMBER_OF_ENCODERS];
 #    endif
     int8_t       mouse_x;
     int8_t       mouse_y;
@@ -425,7 +425,7 @@ bool transport_master(matrix_row_t matrix[]) {
 #    endif
 
 #    ifdef ENCODER_ENABLE
-    encoder_update_raw((uint8_t *)serial_s2m_buffer.encoder_state);
+    encoder_update_raw(serial_s2m_buffer.encoder_state);
 #    endif
 
 #    ifdef WPM_ENABLE
@@ -477,7 +477,7 @@ void transport_slave(matrix_row_t matrix[]) {
 #    endif
 
 #    ifdef ENCODER_ENABLE
-    encoder_state_raw((uint8_t *)serial_s2m_buffer.encoder_state);
+    encoder_state_raw(serial_s2m_buffer.encoder_state);
 #    endif
 
 #    ifdef WPM_ENABLE
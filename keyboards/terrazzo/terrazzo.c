@@ -44,6 +44,55 @@ const is31_led g_is31_leds[DRIVER_LED_TOTAL] = {
     {0, C2_15},{0, C2_14},{0, C2_13},{0, C2_12},{0, C2_11},{0, C2_10},{0, C2_9}
 };
 
+led_config_t g_led_config = {
+    {
+        // Key Matrix to LED Index (the 15x7 display is not mapped to any key)
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED },
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED },
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED },
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED },
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED },
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED },
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED },
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED },
+        { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED }
+    }, {
+        // LED Index to Physical Position
+        {   0,  0 }, {  37,  0 }, {  75,  0 }, { 112,  0 }, { 149,  0 }, { 187,  0 }, { 224,  0 },
+        {   0,  5 }, {  37,  5 }, {  75,  5 }, { 112,  5 }, { 149,  5 }, { 187,  5 }, { 224,  5 },
+        {   0,  9 }, {  37,  9 }, {  75,  9 }, { 112,  9 }, { 149,  9 }, { 187,  9 }, { 224,  9 },
+        {   0, 14 }, {  37, 14 }, {  75, 14 }, { 112, 14 }, { 149, 14 }, { 187, 14 }, { 224, 14 },
+        {   0, 18 }, {  37, 18 }, {  75, 18 }, { 112, 18 }, { 149, 18 }, { 187, 18 }, { 224, 18 },
+        {   0, 23 }, {  37, 23 }, {  75, 23 }, { 112, 23 }, { 149, 23 }, { 187, 23 }, { 224, 23 },
+        {   0, 27 }, {  37, 27 }, {  75, 27 }, { 112, 27 }, { 149, 27 }, { 187, 27 }, { 224, 27 },
+        {   0, 32 }, {  37, 32 }, {  75, 32 }, { 112, 32 }, { 149, 32 }, { 187, 32 }, { 224, 32 },
+        {   0, 37 }, {  37, 37 }, {  75, 37 }, { 112, 37 }, { 149, 37 }, { 187, 37 }, { 224, 37 },
+        {   0, 41 }, {  37, 41 }, {  75, 41 }, { 112, 41 }, { 149, 41 }, { 187, 41 }, { 224, 41 },
+        {   0, 46 }, {  37, 46 }, {  75, 46 }, { 112, 46 }, { 149, 46 }, { 187, 46 }, { 224, 46 },
+        {   0, 50 }, {  37, 50 }, {  75, 50 }, { 112, 50 }, { 149, 50 }, { 187, 50 }, { 224, 50 },
+        {   0, 55 }, {  37, 55 }, {  75, 55 }, { 112, 55 }, { 149, 55 }, { 187, 55 }, { 224, 55 },
+        {   0, 59 }, {  37, 59 }, {  75, 59 }, { 112, 59 }, { 149, 59 }, { 187, 59 }, { 224, 59 },
+        {   0, 64 }, {  37, 64 }, {  75, 64 }, { 112, 64 }, { 149, 64 }, { 187, 64 }, { 224, 64 }
+    }, {
+        // LED Index to Flag
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8,
+        8, 8, 8, 8, 8, 8, 8
+    }
+};
+
 #define TERRAZZO_EFFECT(name)
 #define TERRAZZO_EFFECT_IMPLS
 
@@ -0,0 +1,87 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "adaptive_tapping.h"
+
+#if ADAPTIVE_TAPPING_TERM_KEYS < 1 || ADAPTIVE_TAPPING_TERM_KEYS > 255
+#    error ADAPTIVE_TAPPING_TERM_KEYS must be between 1 and 255
+#endif
+
+typedef struct {
+    uint16_t keycode;
+    uint16_t mean8;    // mean tap duration in ms, times 8
+    uint16_t dev4;     // mean absolute deviation in ms, times 4
+    uint8_t  samples;  // saturates at 255, decremented while other keys compete for the slot
+} tap_stats_t;
+
+static tap_stats_t tap_stats[ADAPTIVE_TAPPING_TERM_KEYS];
+
+static tap_stats_t *find_tap_stats(uint16_t keycode) {
+    for (uint8_t i = 0; i < ADAPTIVE_TAPPING_TERM_KEYS; i++) {
+        if (tap_stats[i].samples && tap_stats[i].keycode == keycode) {
+            return &tap_stats[i];
+        }
+    }
+    return NULL;
+}
+
+void adaptive_tapping_reset(void) { memset(tap_stats, 0, sizeof(tap_stats)); }
+
+uint16_t adaptive_tapping_term(uint16_t keycode, uint16_t tapping_term) {
+    const tap_stats_t *stats = find_tap_stats(keycode);
+    if (!stats || stats->samples < ADAPTIVE_TAPPING_TERM_SAMPLES || tapping_term <= ADAPTIVE_TAPPING_TERM_MIN) {
+        return tapping_term;
+    }
+    uint16_t term = (stats->mean8 >> 3) + stats->dev4;
+    if (term < ADAPTIVE_TAPPING_TERM_MIN) {
+        return ADAPTIVE_TAPPING_TERM_MIN;
+    }
+    return term < tapping_term ? term : tapping_term;
+}
+
+void adaptive_tapping_record_tap(uint16_t keycode, uint16_t duration) {
+    if (keycode == 0 || duration >= 4096) {
+        // Out of range for the fixed point sums, and far longer than any sensible tapping term anyway
+        return;
+    }
+    tap_stats_t *stats = find_tap_stats(keycode);
+    if (stats) {
+        // Same estimator TCP uses for round trip times: mean += err / 8, dev += (|err| - dev) / 4
+        int16_t err = (int16_t)duration - (int16_t)(stats->mean8 >> 3);
+        stats->mean8 += err;
+        stats->dev4 += (err < 0 ? -err : err) - (stats->dev4 >> 2);
+        if (stats->samples < UINT8_MAX) {
+            stats->samples++;
+        }
+    } else {
+        // A key without a slot wears down the least used one, and only takes it over once that has no samples left
+        stats = &tap_stats[0];
+        for (uint8_t i = 1; i < ADAPTIVE_TAPPING_TERM_KEYS && stats->samples; i++) {
+            if (tap_stats[i].samples < stats->samples) {
+                stats = &tap_stats[i];
+            }
+        }
+        if (stats->samples) {
+            stats->samples--;
+        } else {
+            stats->keycode = keycode;
+            stats->mean8   = duration << 3;
+            stats->dev4    = duration << 1;
+            stats->samples = 1;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Number of keys whose tap durations are learned at once
+#ifndef ADAPTIVE_TAPPING_TERM_KEYS
+#    define ADAPTIVE_TAPPING_TERM_KEYS 8
+#endif
+
+// Learned terms are never shorter than this, so a run of very quick taps cannot make a key impossible to hold
+#ifndef ADAPTIVE_TAPPING_TERM_MIN
+#    define ADAPTIVE_TAPPING_TERM_MIN 120
+#endif
+
+// Number of taps a key needs before its learned term replaces the configured one
+#ifndef ADAPTIVE_TAPPING_TERM_SAMPLES
+#    define ADAPTIVE_TAPPING_TERM_SAMPLES 16
+#endif
+
+/* Adaptive tapping term
+ *
+ * Keeps a running mean and mean absolute deviation of how long each tap-hold key is held when it is tapped, for up
+ * to ADAPTIVE_TAPPING_TERM_KEYS keys. Once a key has enough samples its term becomes mean + 4 * deviation, limited
+ * to between ADAPTIVE_TAPPING_TERM_MIN and the configured term, so quick typists get their holds sooner while a
+ * slow tap is still never mistaken for a hold.
+ *
+ * The statistics only live in RAM and are learned again after every power cycle.
+ */
+
+// Forgets every learned term
+void adaptive_tapping_reset(void);
+
+// Returns the learned term for keycode, or tapping_term if it has not been learned yet
+uint16_t adaptive_tapping_term(uint16_t keycode, uint16_t tapping_term);
+
+// Records that keycode was pressed and released within its configured term, with no other key pressed in between
+void adaptive_tapping_record_tap(uint16_t keycode, uint16_t duration);
@@ -14,6 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <string.h>
 #include "audio.h"
 #include "eeconfig.h"
 #include "timer.h"
@@ -72,7 +73,12 @@ bool playing_note   = false;  // or (possibly multiple simultaneous) tones
 bool state_changed  = false;  // global flag, which is set if anything changes with the active_tones
 
 // melody/SONG related state variables
-float (*notes_pointer)[][2];                            // SONG, an array of MUSICAL_NOTEs
+#ifdef AUDIO_COMPACT_SONGS
+const musical_note_t *notes_pointer;     // SONG, an array of MUSICAL_NOTEs
+bool                  notes_in_progmem;  // played through audio_play_melody_P?
+#else
+float (*notes_pointer)[][2];  // SONG, an array of MUSICAL_NOTEs
+#endif
 uint16_t notes_count;                                   // length of the notes_pointer array
 bool     notes_repeat;                                  // PLAY_SONG or PLAY_LOOP?
 uint16_t melody_current_note_duration = 0;              // duration of the currently playing note from the active melody, in ms
@@ -81,6 +87,28 @@ uint16_t current_note                 = 0;              // index into the array
 bool     note_resting                 = false;          // if a short pause was introduced between two notes with the same frequency while playing a melody
 uint16_t last_timestamp               = 0;
 
+#ifdef AUDIO_COMPACT_SONGS
+// milliseconds per 1/64 beat at note_tempo, in 1/256 ms; kept up to date by the tempo functions so that note durations need neither float math nor a division
+static uint16_t duration_ms_scale = 60UL * 1000 * 256 / (64 * TEMPO_DEFAULT);
+
+static musical_note_t melody_note(uint16_t index) {
+    musical_note_t note;
+    if (notes_in_progmem) {
+        memcpy_P(&note, &notes_pointer[index], sizeof(note));
+    } else {
+        note = notes_pointer[index];
+    }
+    return note;
+}
+#    define MELODY_PITCH(index) (melody_note(index).pitch)
+#    define MELODY_FREQUENCY(index) ((float)MELODY_PITCH(index) / NOTE_PITCH_SCALE)
+#    define MELODY_DURATION(index) (melody_note(index).duration)
+#else
+#    define MELODY_PITCH(index) ((*notes_pointer)[index][0])
+#    define MELODY_FREQUENCY(index) MELODY_PITCH(index)
+#    define MELODY_DURATION(index) ((*notes_pointer)[index][1])
+#endif
+
 #ifdef AUDIO_ENABLE_TONE_MULTIPLEXING
 #    ifndef AUDIO_MAX_SIMULTANEOUS_TONES
 #        define AUDIO_MAX_SIMULTANEOUS_TONES 3
@@ -104,9 +132,9 @@ extern uint16_t voices_timer;
 #ifndef AUDIO_OFF_SONG
 #    define AUDIO_OFF_SONG SONG(AUDIO_OFF_SOUND)
 #endif
-float startup_song[][2]   = STARTUP_SONG;
-float audio_on_song[][2]  = AUDIO_ON_SONG;
-float audio_off_song[][2] = AUDIO_OFF_SONG;
+SONG_NOTES(startup_song[])   = STARTUP_SONG;
+SONG_NOTES(audio_on_song[])  = AUDIO_ON_SONG;
+SONG_NOTES(audio_off_song[]) = AUDIO_OFF_SONG;
 
 static bool    audio_initialized    = false;
 static bool    audio_driver_stopped = true;
@@ -290,7 +318,11 @@ void audio_play_note(float pitch, uint16_t duration) {
 
 void audio_play_tone(float pitch) { audio_play_note(pitch, 0xffff); }
 
+#ifdef AUDIO_COMPACT_SONGS
+static void melody_start(const musical_note_t *np, uint16_t n_count, bool n_repeat, bool in_progmem) {
+#else
 void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+#endif
     if (!audio_config.enable) {
         audio_stop_all();
         return;
@@ -309,16 +341,41 @@ void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat) {
     notes_pointer = np;
     notes_count   = n_count;
     notes_repeat  = n_repeat;
+#ifdef AUDIO_COMPACT_SONGS
+    notes_in_progmem = in_progmem;
+#endif
 
     current_note = 0;  // note in the melody-array/list at note_pointer
 
     // start first note manually, which also starts the audio_driver
     // all following/remaining notes are played by 'audio_update_state'
-    audio_play_note((*notes_pointer)[current_note][0], audio_duration_to_ms((*notes_pointer)[current_note][1]));
+    audio_play_note(MELODY_FREQUENCY(current_note), audio_duration_to_ms(MELODY_DURATION(current_note)));
     last_timestamp               = timer_read();
-    melody_current_note_duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+    melody_current_note_duration = audio_duration_to_ms(MELODY_DURATION(current_note));
 }
 
+#ifdef AUDIO_COMPACT_SONGS
+void audio_play_melody(const musical_note_t *np, uint16_t n_count, bool n_repeat) { melody_start(np, n_count, n_repeat, false); }
+
+void audio_play_melody_P(const musical_note_t *np, uint16_t n_count, bool n_repeat) { melody_start(np, n_count, n_repeat, true); }
+#endif
+
+#ifdef AUDIO_COMPACT_SONGS
+musical_note_t click[2];
+void           audio_play_click(uint16_t delay, float pitch, uint16_t duration) {
+    uint16_t duration_tone  = audio_ms_to_duration(duration);
+    uint16_t duration_delay = audio_ms_to_duration(delay);
+
+    // first note is a rest/pause, skipped if there is no delay
+    click[0] = (musical_note_t){.pitch = 0, .duration = MIN(duration_delay, UINT8_MAX)};
+    click[1] = (musical_note_t){.pitch = NOTE_PITCH_FIXED(pitch), .duration = MIN(duration_tone, UINT8_MAX)};
+    if (delay <= 0.0f) {
+        audio_play_melody(&click[1], 1, false);
+    } else {
+        audio_play_melody(click, 2, false);
+    }
+}
+#else
 float click[2][2];
 void  audio_play_click(uint16_t delay, float pitch, uint16_t duration) {
     uint16_t duration_tone  = audio_ms_to_duration(duration);
@@ -340,6 +397,7 @@ void  audio_play_click(uint16_t delay, float pitch, uint16_t duration) {
         audio_play_melody(&click, 2, false);
     }
 }
+#endif
 
 bool audio_is_playing_note(void) { return playing_note; }
 
@@ -401,7 +459,7 @@ bool audio_update_state(void) {
                 }
             }
 
-            if (!note_resting && (*notes_pointer)[previous_note][0] == (*notes_pointer)[current_note][0]) {
+            if (!note_resting && MELODY_PITCH(previous_note) == MELODY_PITCH(current_note)) {
                 note_resting = true;
 
                 // special handling for successive notes of the same frequency:
@@ -425,13 +483,13 @@ bool audio_update_state(void) {
 
                 // '- delta': Skip forward in the next note's length if we've over shot
                 //            the last, so the overall length of the song is the same
-                uint16_t duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+                uint16_t duration = audio_duration_to_ms(MELODY_DURATION(current_note));
 
                 // Skip forward past any completely missed notes
                 while (delta > duration && current_note < notes_count - 1) {
                     delta -= duration;
                     current_note++;
-                    duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+                    duration = audio_duration_to_ms(MELODY_DURATION(current_note));
                 }
 
                 if (delta < duration) {
@@ -442,7 +500,7 @@ bool audio_update_state(void) {
                     duration = 1;
                 }
 
-                audio_play_note((*notes_pointer)[current_note][0], duration);
+                audio_play_note(MELODY_FREQUENCY(current_note), duration);
                 melody_current_note_duration = duration;
             }
         }
@@ -498,12 +556,19 @@ void audio_decrease_tone_multiplexing_rate(uint16_t change) {
 
 // Tempo functions
 
+static void tempo_changed(void) {
+#ifdef AUDIO_COMPACT_SONGS
+    duration_ms_scale = 60UL * 1000 * 256 / (64 * note_tempo);
+#endif
+}
+
 void audio_set_tempo(uint8_t tempo) {
     if (tempo < 10) note_tempo = 10;
     //  else if (tempo > 250)
     //      note_tempo = 250;
     else
         note_tempo = tempo;
+    tempo_changed();
 }
 
 void audio_increase_tempo(uint8_t tempo_change) {
@@ -511,6 +576,7 @@ void audio_increase_tempo(uint8_t tempo_change) {
         note_tempo = 255;
     else
         note_tempo += tempo_change;
+    tempo_changed();
 }
 
 void audio_decrease_tempo(uint8_t tempo_change) {
@@ -518,11 +584,14 @@ void audio_decrease_tempo(uint8_t tempo_change) {
         note_tempo = 10;
     else
         note_tempo -= tempo_change;
+    tempo_changed();
 }
 
 // TODO in the int-math version are some bugs; songs sometimes abruptly end - maybe an issue with the timer/system-tick wrapping around?
 uint16_t audio_duration_to_ms(uint16_t duration_bpm) {
-#if defined(__AVR__)
+#if defined(AUDIO_COMPACT_SONGS)
+    return ((uint32_t)duration_bpm * duration_ms_scale) >> 8;
+#elif defined(__AVR__)
     // doing int-math saves us some bytes in the overall firmware size, but the intermediate result is less accurate before being cast to/returned as uint
     return ((uint32_t)duration_bpm * 60 * 1000) / (64 * note_tempo);
     // NOTE: beware of uint16_t overflows when note_tempo is low and/or the duration is long
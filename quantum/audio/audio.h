@@ -66,6 +66,17 @@ typedef struct {
     // uint8_t timbre;     // range: [0,100] TODO: this currently kept track of globally, should we do this per tone instead?
 } musical_tone_t;
 
+#ifdef AUDIO_COMPACT_SONGS
+/*
+ * a SONG entry as stored in flash when AUDIO_COMPACT_SONGS is enabled: the MUSICAL_NOTE macros convert each pitch to
+ * fixed point at compile time, so playing a melody needs no float math until a note is handed to the driver
+ */
+typedef struct {
+    uint16_t pitch;     // in 1/NOTE_PITCH_SCALE Hz, 0 is a rest
+    uint8_t  duration;  // in the musical_notes.h unit, 64 parts to a beat
+} musical_note_t;
+#endif
+
 // public interface
 
 /**
@@ -145,7 +156,15 @@ void audio_stop_tone(float pitch);
  * @param[in] n_count number of MUSICAL_NOTES of the SONG
  * @param[in] n_repeat false for onetime, true for looped playback
  */
+#ifdef AUDIO_COMPACT_SONGS
+void audio_play_melody(const musical_note_t *np, uint16_t n_count, bool n_repeat);
+/**
+ * @brief play a melody stored in PROGMEM, see audio_play_melody
+ */
+void audio_play_melody_P(const musical_note_t *np, uint16_t n_count, bool n_repeat);
+#else
 void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat);
+#endif
 
 /**
  * @brief play a short tone of a specific frequency to emulate a 'click'
@@ -183,15 +202,31 @@ bool audio_is_playing_melody(void);
 // The global float array for the song must be used here.
 #define NOTE_ARRAY_SIZE(x) ((int16_t)(sizeof(x) / (sizeof(x[0]))))
 
+/**
+ * @brief declares a SONG array, which works with and without AUDIO_COMPACT_SONGS
+ * @details 'SONG_NOTES(my_song[]) = SONG(...);' expands to 'float my_song[][2]', or
+ *          with AUDIO_COMPACT_SONGS to 'const musical_note_t my_song[] PROGMEM'
+ */
+#ifdef AUDIO_COMPACT_SONGS
+#    define SONG_NOTES(name) const musical_note_t name PROGMEM
+#else
+#    define SONG_NOTES(name) float name[2]
+#endif
+
+#ifdef AUDIO_COMPACT_SONGS
+#    define PLAY_SONG(note_array) audio_play_melody_P(note_array, NOTE_ARRAY_SIZE((note_array)), false)
+#    define PLAY_LOOP(note_array) audio_play_melody_P(note_array, NOTE_ARRAY_SIZE((note_array)), true)
+#else
 /**
  * @brief convenience macro, to play a melody/SONG once
  */
-#define PLAY_SONG(note_array) audio_play_melody(&note_array, NOTE_ARRAY_SIZE((note_array)), false)
+#    define PLAY_SONG(note_array) audio_play_melody(&note_array, NOTE_ARRAY_SIZE((note_array)), false)
 // TODO: a 'song' is a melody plus singing/vocals -> PLAY_MELODY
 /**
  * @brief convenience macro, to play a melody/SONG in a loop, until stopped by 'audio_stop_all'
  */
-#define PLAY_LOOP(note_array) audio_play_melody(&note_array, NOTE_ARRAY_SIZE((note_array)), true)
+#    define PLAY_LOOP(note_array) audio_play_melody(&note_array, NOTE_ARRAY_SIZE((note_array)), true)
+#endif
 
 // Tone-Multiplexing functions
 // this feature only makes sense for hardware setups which can't do proper
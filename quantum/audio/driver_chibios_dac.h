@@ -120,6 +120,24 @@
 #    error "AUDIO_DAC: OFF_VALUE may not be larger than SAMPLE_MAX"
 #endif
 
+/**
+ * Envelope of each voice of the dac_additive driver: attack, decay and release
+ * times in milliseconds, and the sustain level from 0 to 255. The short
+ * defaults only soften the start and end of each tone, to avoid clicks.
+ */
+#ifndef AUDIO_DAC_ENVELOPE_ATTACK
+#    define AUDIO_DAC_ENVELOPE_ATTACK 2
+#endif
+#ifndef AUDIO_DAC_ENVELOPE_DECAY
+#    define AUDIO_DAC_ENVELOPE_DECAY 0
+#endif
+#ifndef AUDIO_DAC_ENVELOPE_SUSTAIN
+#    define AUDIO_DAC_ENVELOPE_SUSTAIN 255
+#endif
+#ifndef AUDIO_DAC_ENVELOPE_RELEASE
+#    define AUDIO_DAC_ENVELOPE_RELEASE 20
+#endif
+
 /**
  *user overridable sample generation/processing
  */
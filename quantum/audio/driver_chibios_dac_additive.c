@@ -26,7 +26,9 @@
 
   it is also possible to have a custom sample-LUT by implementing/overriding 'dac_value_generate'
 
-  this driver allows for multiple simultaneous tones to be played through one single channel by doing additive wave-synthesis
+  this driver allows for multiple simultaneous tones to be played through one single channel by doing additive wave-synthesis:
+  every tone gets a voice with a fixed point phase accumulator and an ADSR envelope, and the voices are mixed into each half
+  of the circular DMA buffer whenever the other half is being played
 */
 
 #if !defined(AUDIO_PIN)
@@ -81,12 +83,6 @@ static const dacsample_t dac_buffer_trapezoid[AUDIO_DAC_BUFFER_SIZE] = {0x0,   0
 
 static dacsample_t dac_buffer_empty[AUDIO_DAC_BUFFER_SIZE] = {AUDIO_DAC_OFF_VALUE};
 
-/* keep track of the sample position for for each frequency */
-static float dac_if[AUDIO_MAX_SIMULTANEOUS_TONES] = {0.0};
-
-static float   active_tones_snapshot[AUDIO_MAX_SIMULTANEOUS_TONES] = {0, 0};
-static uint8_t active_tones_snapshot_length                        = 0;
-
 typedef enum {
     OUTPUT_SHOULD_START,
     OUTPUT_RUN_NORMALLY,
@@ -103,62 +99,177 @@ typedef enum {
 } output_states_t;
 output_states_t state = OUTPUT_OFF_2;
 
+#if defined(AUDIO_DAC_SAMPLE_WAVEFORM_SINE)
+#    define DAC_WAVETABLE dac_buffer_sine
+#    define DAC_WAVETABLE_CENTER 0x800
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE)
+#    define DAC_WAVETABLE dac_buffer_triangle
+#    define DAC_WAVETABLE_CENTER 0x800
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID)
+#    define DAC_WAVETABLE dac_buffer_trapezoid
+#    define DAC_WAVETABLE_CENTER 0x800
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_SQUARE)
+#    define DAC_WAVETABLE dac_buffer_square
+#    define DAC_WAVETABLE_CENTER (AUDIO_DAC_SAMPLE_MAX / 2)
+#endif
+
+_Static_assert((AUDIO_DAC_BUFFER_SIZE & (AUDIO_DAC_BUFFER_SIZE - 1)) == 0, "AUDIO_DAC_BUFFER_SIZE must be a power of two");
+
+/* samples are generated at 3/2 of AUDIO_DAC_SAMPLE_RATE: the gpt timer runs with 3*AUDIO_DAC_SAMPLE_RATE, and the DAC
+ * callback is called twice per conversion (as measured with an oscilloscope)
+ */
+#define DAC_GENERATED_RATE (AUDIO_DAC_SAMPLE_RATE * 3 / 2)
+#define DAC_ENVELOPE_STEP(ms, range) ((ms) ? MAX(1, (range) / ((ms) * (DAC_GENERATED_RATE / 1000))) : (range))
+#define DAC_ENVELOPE_FULL 0xFFFF
+#define DAC_ENVELOPE_SUSTAIN_LEVEL (AUDIO_DAC_ENVELOPE_SUSTAIN * 257)
+#define DAC_ENVELOPE_ATTACK_STEP DAC_ENVELOPE_STEP(AUDIO_DAC_ENVELOPE_ATTACK, DAC_ENVELOPE_FULL)
+#define DAC_ENVELOPE_DECAY_STEP DAC_ENVELOPE_STEP(AUDIO_DAC_ENVELOPE_DECAY, DAC_ENVELOPE_FULL - DAC_ENVELOPE_SUSTAIN_LEVEL)
+#define DAC_ENVELOPE_RELEASE_STEP DAC_ENVELOPE_STEP(AUDIO_DAC_ENVELOPE_RELEASE, DAC_ENVELOPE_FULL)
+
+/* wavetable positions are 16.16 fixed point, wrapping around at the end of the table */
+#define DAC_PHASE_MASK ((AUDIO_DAC_BUFFER_SIZE << 16) - 1)
+
+typedef enum { VOICE_IDLE, VOICE_ATTACK, VOICE_DECAY, VOICE_SUSTAIN, VOICE_RELEASE } voice_stage_t;
+
+typedef struct {
+    float         frequency;  // the tone this voice plays, only compared when the active tones change
+    uint32_t      phase;      // position in the wavetable
+    uint32_t      increment;  // phase advance per generated sample
+    uint16_t      level;      // envelope, DAC_ENVELOPE_FULL is full volume
+    voice_stage_t stage;
+} dac_voice_t;
+
+/* one voice per simultaneous tone; a released voice fades out in its slot until a new tone needs the slot */
+static dac_voice_t dac_voices[AUDIO_MAX_SIMULTANEOUS_TONES];
+static uint8_t     dac_voices_held     = 0;      // voices playing an active tone, the rest is idle or releasing
+static uint8_t     dac_voices_sounding = 0;      // voices that are not idle
+static uint32_t    dac_mix_scale       = 65536;  // 1 / dac_voices_held, 16.16 fixed point
+
+static void dac_voices_update(void) {
+    bool    keep[AUDIO_MAX_SIMULTANEOUS_TONES] = {false};
+    uint8_t active_tones                       = MIN(AUDIO_MAX_SIMULTANEOUS_TONES, audio_get_number_of_active_tones());
+
+    dac_voices_held = 0;
+    for (uint8_t t = 0; t < active_tones; t++) {
+        float freq = audio_get_processed_frequency(t);
+        if (freq <= 0) {  // disregard 'rest' notes, with valid frequency 0.0f; which would only lower the resulting waveform volume during the additive synthesis step
+            continue;
+        }
+        dac_voices_held++;
+
+        // a tone that keeps playing keeps its voice, so its phase and envelope carry on undisturbed
+        dac_voice_t *voice = NULL;
+        for (uint8_t i = 0; i < AUDIO_MAX_SIMULTANEOUS_TONES; i++) {
+            if (!keep[i] && dac_voices[i].stage != VOICE_IDLE && dac_voices[i].stage != VOICE_RELEASE && dac_voices[i].frequency == freq) {
+                voice   = &dac_voices[i];
+                keep[i] = true;
+                break;
+            }
+        }
+        if (voice) {
+            continue;
+        }
+
+        // otherwise take an idle voice, or the quietest released one
+        uint8_t slot = AUDIO_MAX_SIMULTANEOUS_TONES;
+        for (uint8_t i = 0; i < AUDIO_MAX_SIMULTANEOUS_TONES; i++) {
+            if (keep[i] || (dac_voices[i].stage != VOICE_IDLE && dac_voices[i].stage != VOICE_RELEASE)) {
+                continue;
+            }
+            if (slot == AUDIO_MAX_SIMULTANEOUS_TONES || dac_voices[i].stage == VOICE_IDLE || dac_voices[i].level < dac_voices[slot].level) {
+                slot = i;
+                if (dac_voices[i].stage == VOICE_IDLE) {
+                    break;
+                }
+            }
+        }
+        if (slot == AUDIO_MAX_SIMULTANEOUS_TONES) {
+            // every voice is taken by a tone that is still being played and has not been matched yet; it will be released below
+            continue;
+        }
+        voice = &dac_voices[slot];
+        if (voice->stage == VOICE_IDLE) {
+            voice->phase = 0;
+            voice->level = 0;
+        }  // a released voice attacks from where it is, so taking it over does not click
+        keep[slot]       = true;
+        voice->frequency = freq;
+        voice->increment = (uint32_t)(freq * AUDIO_DAC_BUFFER_SIZE * 65536.0f / DAC_GENERATED_RATE);
+        voice->stage     = VOICE_ATTACK;
+    }
+
+    // tones that stopped fade out
+    dac_voices_sounding = 0;
+    for (uint8_t i = 0; i < AUDIO_MAX_SIMULTANEOUS_TONES; i++) {
+        if (!keep[i] && dac_voices[i].stage != VOICE_IDLE) {
+            dac_voices[i].stage = VOICE_RELEASE;
+        }
+        if (dac_voices[i].stage != VOICE_IDLE) {
+            dac_voices_sounding++;
+        }
+    }
+    dac_mix_scale = 65536 / MAX(1, dac_voices_held);
+}
+
+static inline void dac_voice_envelope(dac_voice_t *voice) {
+    switch (voice->stage) {
+        case VOICE_ATTACK:
+            if (voice->level >= DAC_ENVELOPE_FULL - DAC_ENVELOPE_ATTACK_STEP) {
+                voice->level = DAC_ENVELOPE_FULL;
+                voice->stage = VOICE_DECAY;
+            } else {
+                voice->level += DAC_ENVELOPE_ATTACK_STEP;
+            }
+            break;
+        case VOICE_DECAY:
+            if (voice->level <= DAC_ENVELOPE_SUSTAIN_LEVEL + DAC_ENVELOPE_DECAY_STEP) {
+                voice->level = DAC_ENVELOPE_SUSTAIN_LEVEL;
+                voice->stage = VOICE_SUSTAIN;
+            } else {
+                voice->level -= DAC_ENVELOPE_DECAY_STEP;
+            }
+            break;
+        case VOICE_RELEASE:
+            if (voice->level <= DAC_ENVELOPE_RELEASE_STEP) {
+                voice->level = 0;
+                voice->stage = VOICE_IDLE;
+                dac_voices_sounding--;
+            } else {
+                voice->level -= DAC_ENVELOPE_RELEASE_STEP;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
 /**
  * Generation of the waveform being passed to the callback. Declared weak so users
  * can override it with their own wave-forms/noises.
  */
 __attribute__((weak)) uint16_t dac_value_generate(void) {
-    // DAC is running/asking for values but snapshot length is zero -> must be playing a pause
-    if (active_tones_snapshot_length == 0) {
+    // DAC is running/asking for values but no voice is sounding -> must be playing a pause
+    if (dac_voices_sounding == 0) {
         return AUDIO_DAC_OFF_VALUE;
     }
 
-    /* doing additive wave synthesis over all currently playing tones = adding up
-     * sine-wave-samples for each frequency, scaled by the number of active tones
+    /* doing additive wave synthesis over all sounding voices = adding up wavetable samples around the center of the
+     * table, each scaled by its envelope, with integer math only so the cost per voice is fixed
      */
-    uint16_t value     = 0;
-    float    frequency = 0.0f;
-
-    for (uint8_t i = 0; i < active_tones_snapshot_length; i++) {
-        /* Note: a user implementation does not have to rely on the active_tones_snapshot, but
-         * could directly query the active frequencies through audio_get_processed_frequency */
-        frequency = active_tones_snapshot[i];
-
-        dac_if[i] = dac_if[i] + ((frequency * AUDIO_DAC_BUFFER_SIZE) / AUDIO_DAC_SAMPLE_RATE) * 2 / 3;
-        /*Note: the 2/3 are necessary to get the correct frequencies on the
-         *      DAC output (as measured with an oscilloscope), since the gpt
-         *      timer runs with 3*AUDIO_DAC_SAMPLE_RATE; and the DAC callback
-         *      is called twice per conversion.*/
-
-        dac_if[i] = fmod(dac_if[i], AUDIO_DAC_BUFFER_SIZE);
-
-        // Wavetable generation/lookup
-        uint16_t dac_i = (uint16_t)dac_if[i];
-
-#if defined(AUDIO_DAC_SAMPLE_WAVEFORM_SINE)
-        value += dac_buffer_sine[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE)
-        value += dac_buffer_triangle[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID)
-        value += dac_buffer_trapezoid[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_SQUARE)
-        value += dac_buffer_square[dac_i] / active_tones_snapshot_length;
-#endif
-        /*
-        // SINE
-        value += dac_buffer_sine[dac_i] / active_tones_snapshot_length / 3;
-        // TRIANGLE
-        value += dac_buffer_triangle[dac_i] / active_tones_snapshot_length / 3;
-        // SQUARE
-        value += dac_buffer_square[dac_i] / active_tones_snapshot_length / 3;
-        //NOTE: combination of these three wave-forms is more exemplary - and doesn't sound particularly good :-P
-        */
-
-        // STAIRS (mostly usefully as test-pattern)
-        // value_avg = dac_buffer_staircase[dac_i] / active_tones_snapshot_length;
+    int32_t mix = 0;
+    for (uint8_t i = 0; i < AUDIO_MAX_SIMULTANEOUS_TONES; i++) {
+        dac_voice_t *voice = &dac_voices[i];
+        if (voice->stage == VOICE_IDLE) {
+            continue;
+        }
+        dac_voice_envelope(voice);
+        voice->phase = (voice->phase + voice->increment) & DAC_PHASE_MASK;
+        mix += (((int32_t)DAC_WAVETABLE[voice->phase >> 16] - DAC_WAVETABLE_CENTER) * voice->level) >> 16;
     }
 
-    return value;
+    int32_t value = DAC_WAVETABLE_CENTER + ((mix * (int32_t)dac_mix_scale) >> 16);
+    // released voices add on top of the held ones, which may briefly exceed the range
+    return value < 0 ? 0 : (value > (int32_t)AUDIO_DAC_SAMPLE_MAX ? AUDIO_DAC_SAMPLE_MAX : value);
 }
 
 /**
@@ -199,7 +310,7 @@ static void dac_end(DACDriver *dacp) {
         if (((sample_p[s] + (AUDIO_DAC_SAMPLE_MAX / 100)) > AUDIO_DAC_OFF_VALUE) &&  // value approaches from below
             (sample_p[s] < (AUDIO_DAC_OFF_VALUE + (AUDIO_DAC_SAMPLE_MAX / 100)))     // or above
         ) {
-            if ((OUTPUT_SHOULD_START == state) && (active_tones_snapshot_length > 0)) {
+            if ((OUTPUT_SHOULD_START == state) && (dac_voices_held > 0)) {
                 state = OUTPUT_RUN_NORMALLY;
             } else if (OUTPUT_TONES_CHANGED == state) {
                 state = OUTPUT_REACHED_ZERO_BEFORE_TONE_CHANGE;
@@ -214,18 +325,11 @@ static void dac_end(DACDriver *dacp) {
         }
 
         if ((OUTPUT_SHOULD_START == state) || (OUTPUT_REACHED_ZERO_BEFORE_OFF == state) || (OUTPUT_REACHED_ZERO_BEFORE_TONE_CHANGE == state)) {
-            uint8_t active_tones         = MIN(AUDIO_MAX_SIMULTANEOUS_TONES, audio_get_number_of_active_tones());
-            active_tones_snapshot_length = 0;
-            // update the snapshot - once, and only on occasion that something changed;
-            // -> saves cpu cycles (?)
-            for (uint8_t i = 0; i < active_tones; i++) {
-                float freq = audio_get_processed_frequency(i);
-                if (freq > 0) {  // disregard 'rest' notes, with valid frequency 0.0f; which would only lower the resulting waveform volume during the additive synthesis step
-                    active_tones_snapshot[active_tones_snapshot_length++] = freq;
-                }
-            }
+            // update the voices - once, and only on occasion that something changed
+            dac_voices_update();
 
-            if ((0 == active_tones_snapshot_length) && (OUTPUT_REACHED_ZERO_BEFORE_OFF == state)) {
+            // let released voices fade out before the output is turned off
+            if ((0 == dac_voices_sounding) && (OUTPUT_REACHED_ZERO_BEFORE_OFF == state)) {
                 state = OUTPUT_OFF;
             }
             if (OUTPUT_REACHED_ZERO_BEFORE_TONE_CHANGE == state) {
@@ -327,9 +431,10 @@ void audio_driver_start(void) {
     gptStartContinuous(&GPTD6, 2U);
 
     for (uint8_t i = 0; i < AUDIO_MAX_SIMULTANEOUS_TONES; i++) {
-        dac_if[i]                = 0.0f;
-        active_tones_snapshot[i] = 0.0f;
+        dac_voices[i].stage = VOICE_IDLE;
+        dac_voices[i].level = 0;
     }
-    active_tones_snapshot_length = 0;
-    state                        = OUTPUT_SHOULD_START;
+    dac_voices_held     = 0;
+    dac_voices_sounding = 0;
+    state               = OUTPUT_SHOULD_START;
 }
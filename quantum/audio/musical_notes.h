@@ -25,8 +25,16 @@
     { notes }
 
 // Note Types
-#define MUSICAL_NOTE(note, duration) \
-    { (NOTE##note), duration }
+#ifdef AUDIO_COMPACT_SONGS
+// pitch stored as fixed point with 3 fractional bits, which still fits NOTE_B8 into 16 bits; converted by the compiler
+#    define NOTE_PITCH_SCALE 8
+#    define NOTE_PITCH_FIXED(pitch) ((uint16_t)((pitch)*NOTE_PITCH_SCALE + 0.5f))
+#    define MUSICAL_NOTE(note, duration) \
+        { NOTE_PITCH_FIXED(NOTE##note), duration }
+#else
+#    define MUSICAL_NOTE(note, duration) \
+        { (NOTE##note), duration }
+#endif
 
 #define BREVE_NOTE(note) MUSICAL_NOTE(note, 128)
 #define WHOLE_NOTE(note) MUSICAL_NOTE(note, 64)
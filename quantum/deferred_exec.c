@@ -0,0 +1,163 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include "deferred_exec.h"
+#include "timer.h"
+
+#if MAX_DEFERRED_EXECUTORS > 127
+#    error MAX_DEFERRED_EXECUTORS must be less than 128
+#endif
+
+typedef struct {
+    uint32_t               trigger_time;
+    deferred_exec_callback callback;
+    void *                 cb_arg;
+    deferred_token         token;
+} deferred_executor_t;
+
+// Binary min-heap ordered by trigger_time, so the next deadline is always executors[0]
+static deferred_executor_t executors[MAX_DEFERRED_EXECUTORS];
+static uint8_t             executor_count = 0;
+static deferred_token      last_token     = INVALID_DEFERRED_TOKEN;
+
+// Wraparound safe as long as deadlines are less than ~24 days apart
+#define DEADLINE_BEFORE(a, b) ((int32_t)((a) - (b)) < 0)
+
+static void swap_executors(uint8_t a, uint8_t b) {
+    deferred_executor_t tmp = executors[a];
+    executors[a]            = executors[b];
+    executors[b]            = tmp;
+}
+
+static uint8_t sift_up(uint8_t i) {
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (!DEADLINE_BEFORE(executors[i].trigger_time, executors[parent].trigger_time)) {
+            break;
+        }
+        swap_executors(i, parent);
+        i = parent;
+    }
+    return i;
+}
+
+static void sift_down(uint8_t i) {
+    for (;;) {
+        uint8_t left     = 2 * i + 1;
+        uint8_t right    = left + 1;
+        uint8_t earliest = i;
+        if (left < executor_count && DEADLINE_BEFORE(executors[left].trigger_time, executors[earliest].trigger_time)) {
+            earliest = left;
+        }
+        if (right < executor_count && DEADLINE_BEFORE(executors[right].trigger_time, executors[earliest].trigger_time)) {
+            earliest = right;
+        }
+        if (earliest == i) {
+            return;
+        }
+        swap_executors(i, earliest);
+        i = earliest;
+    }
+}
+
+// Restores heap order after the trigger_time of executors[i] changed
+static void reheap(uint8_t i) { sift_down(sift_up(i)); }
+
+static int8_t find_executor(deferred_token token) {
+    if (token == INVALID_DEFERRED_TOKEN) {
+        return -1;
+    }
+    for (uint8_t i = 0; i < executor_count; i++) {
+        if (executors[i].token == token) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void remove_executor(uint8_t i) {
+    executor_count--;
+    if (i != executor_count) {
+        executors[i] = executors[executor_count];
+        reheap(i);
+    }
+}
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
+    if (delay_ms == 0 || callback == NULL || executor_count >= MAX_DEFERRED_EXECUTORS) {
+        return INVALID_DEFERRED_TOKEN;
+    }
+
+    // Tokens are handed out round robin, skipping any that are still scheduled
+    do {
+        last_token++;
+    } while (last_token == INVALID_DEFERRED_TOKEN || find_executor(last_token) >= 0);
+
+    uint8_t i                 = executor_count++;
+    executors[i].trigger_time = timer_read32() + delay_ms;
+    executors[i].callback     = callback;
+    executors[i].cb_arg       = cb_arg;
+    executors[i].token        = last_token;
+    sift_up(i);
+    return last_token;
+}
+
+bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
+    int8_t i = find_executor(token);
+    if (i < 0) {
+        return false;
+    }
+    executors[i].trigger_time = timer_read32() + delay_ms;
+    reheap(i);
+    return true;
+}
+
+bool cancel_deferred_exec(deferred_token token) {
+    int8_t i = find_executor(token);
+    if (i < 0) {
+        return false;
+    }
+    remove_executor(i);
+    return true;
+}
+
+void deferred_exec_task(void) {
+    if (executor_count == 0) {
+        return;
+    }
+
+    uint32_t now = timer_read32();
+
+    // At most MAX_DEFERRED_EXECUTORS callbacks run per call. A periodic callback that fell behind is rescheduled from
+    // its previous deadline and may run several times in one call, but catches up over later scans past that bound
+    for (uint8_t n = 0; n < MAX_DEFERRED_EXECUTORS && executor_count > 0 && !DEADLINE_BEFORE(now, executors[0].trigger_time); n++) {
+        // The callback may schedule or cancel executors, so work from a copy and look the entry up again afterwards
+        deferred_executor_t executor = executors[0];
+        uint32_t            delay_ms = executor.callback(executor.trigger_time, executor.cb_arg);
+
+        int8_t i = find_executor(executor.token);
+        if (i < 0) {
+            continue;
+        }
+        if (delay_ms) {
+            executors[i].trigger_time = executor.trigger_time + delay_ms;
+            reheap(i);
+        } else {
+            remove_executor(i);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* One slot for each callback an enabled feature can have scheduled at the same time, plus room for keyboard and
+ * user code. The features rely on these slots for their timeouts, so raise MAX_DEFERRED_EXECUTORS rather than let
+ * keyboard and user code take more than the four left for them.
+ */
+#ifdef TAP_DANCE_ENABLE
+#    define DEFERRED_EXEC_SLOTS_TAP_DANCE 2  // a dance being interrupted by the next one
+#else
+#    define DEFERRED_EXEC_SLOTS_TAP_DANCE 0
+#endif
+#ifdef COMBO_ENABLE
+#    define DEFERRED_EXEC_SLOTS_COMBO 1
+#else
+#    define DEFERRED_EXEC_SLOTS_COMBO 0
+#endif
+#ifdef LEADER_ENABLE
+#    define DEFERRED_EXEC_SLOTS_LEADER 1
+#else
+#    define DEFERRED_EXEC_SLOTS_LEADER 0
+#endif
+#ifdef AUTO_SHIFT_ENABLE
+#    define DEFERRED_EXEC_SLOTS_AUTO_SHIFT 1
+#else
+#    define DEFERRED_EXEC_SLOTS_AUTO_SHIFT 0
+#endif
+#ifdef WPM_ENABLE
+#    define DEFERRED_EXEC_SLOTS_WPM 1
+#else
+#    define DEFERRED_EXEC_SLOTS_WPM 0
+#endif
+#ifdef STENO_ENABLE
+#    define DEFERRED_EXEC_SLOTS_STENO 1
+#else
+#    define DEFERRED_EXEC_SLOTS_STENO 0
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+#    define DEFERRED_EXEC_SLOTS_DYNAMIC_MACRO 1
+#else
+#    define DEFERRED_EXEC_SLOTS_DYNAMIC_MACRO 0
+#endif
+#ifdef AUDIO_ENABLE
+#    define DEFERRED_EXEC_SLOTS_AUDIO 1  // startup song
+#else
+#    define DEFERRED_EXEC_SLOTS_AUDIO 0
+#endif
+#ifdef HAPTIC_ENABLE
+#    define DEFERRED_EXEC_SLOTS_HAPTIC 1  // solenoid
+#else
+#    define DEFERRED_EXEC_SLOTS_HAPTIC 0
+#endif
+
+#ifndef MAX_DEFERRED_EXECUTORS
+#    define MAX_DEFERRED_EXECUTORS (4 + DEFERRED_EXEC_SLOTS_TAP_DANCE + DEFERRED_EXEC_SLOTS_COMBO + DEFERRED_EXEC_SLOTS_LEADER + DEFERRED_EXEC_SLOTS_AUTO_SHIFT + DEFERRED_EXEC_SLOTS_WPM + DEFERRED_EXEC_SLOTS_STENO + DEFERRED_EXEC_SLOTS_DYNAMIC_MACRO + DEFERRED_EXEC_SLOTS_AUDIO + DEFERRED_EXEC_SLOTS_HAPTIC)
+#endif
+
+// A token of 0 never refers to a scheduled callback
+typedef uint8_t deferred_token;
+#define INVALID_DEFERRED_TOKEN 0
+
+/* Callback invoked once its deadline has passed
+ *
+ * trigger_time is the timer_read32() value the callback was scheduled for. Return 0 to stop, or the number of
+ * milliseconds after trigger_time at which the callback should run again.
+ */
+typedef uint32_t (*deferred_exec_callback)(uint32_t trigger_time, void *cb_arg);
+
+/* Schedules callback to run delay_ms from now
+ *
+ * Returns INVALID_DEFERRED_TOKEN if delay_ms is 0, callback is NULL, or all MAX_DEFERRED_EXECUTORS slots are in use.
+ */
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg);
+
+// Moves the deadline of a scheduled callback to delay_ms from now, returns false if token is not scheduled
+bool extend_deferred_exec(deferred_token token, uint32_t delay_ms);
+
+// Removes a scheduled callback, returns false if token is not scheduled
+bool cancel_deferred_exec(deferred_token token);
+
+// Runs every callback whose deadline has passed, called from matrix_scan_quantum()
+void deferred_exec_task(void);
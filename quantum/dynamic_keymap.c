@@ -73,10 +73,23 @@
 #    error Dynamic keymaps are configured to use more EEPROM than is available.
 #endif
 
+// Recorded dynamic macros (DYNAMIC_MACRO_ENABLE) can be saved to the
+// last DYNAMIC_MACRO_EEPROM_SIZE bytes of the macro area.
+#if !defined(DYNAMIC_MACRO_ENABLE) || !defined(DYNAMIC_MACRO_EEPROM_SIZE)
+#    undef DYNAMIC_MACRO_EEPROM_SIZE
+#    define DYNAMIC_MACRO_EEPROM_SIZE 0
+#endif
+
 // Dynamic macros are stored after the keymaps and use what is available
 // up to and including DYNAMIC_KEYMAP_EEPROM_MAX_ADDR.
 #ifndef DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE
-#    define DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1)
+#    define DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1 - DYNAMIC_MACRO_EEPROM_SIZE)
+#endif
+
+#define DYNAMIC_MACRO_EEPROM_ADDR (DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE)
+
+#if DYNAMIC_MACRO_EEPROM_ADDR + DYNAMIC_MACRO_EEPROM_SIZE - 1 > DYNAMIC_KEYMAP_EEPROM_MAX_ADDR
+#    error Recorded dynamic macros are configured to use more EEPROM than is available.
 #endif
 
 uint8_t dynamic_keymap_get_layer_count(void) { return DYNAMIC_KEYMAP_LAYER_COUNT; }
@@ -182,14 +195,43 @@ void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_reset(void) {
+    // Also clears the recorded dynamic macros, which directly follow the macro buffer
     void *p   = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
-    void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
+    void *end = (void *)(DYNAMIC_MACRO_EEPROM_ADDR + DYNAMIC_MACRO_EEPROM_SIZE);
     while (p != end) {
         eeprom_update_byte(p, 0);
         ++p;
     }
 }
 
+uint16_t dynamic_keymap_recorded_macro_get_buffer_size(void) { return DYNAMIC_MACRO_EEPROM_SIZE; }
+
+void dynamic_keymap_recorded_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    void *   source = (void *)(DYNAMIC_MACRO_EEPROM_ADDR + offset);
+    uint8_t *target = data;
+    for (uint16_t i = 0; i < size; i++) {
+        if (offset + i < DYNAMIC_MACRO_EEPROM_SIZE) {
+            *target = eeprom_read_byte(source);
+        } else {
+            *target = 0x00;
+        }
+        source++;
+        target++;
+    }
+}
+
+void dynamic_keymap_recorded_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    void *   target = (void *)(DYNAMIC_MACRO_EEPROM_ADDR + offset);
+    uint8_t *source = data;
+    for (uint16_t i = 0; i < size; i++) {
+        if (offset + i < DYNAMIC_MACRO_EEPROM_SIZE) {
+            eeprom_update_byte(target, *source);
+        }
+        source++;
+        target++;
+    }
+}
+
 void dynamic_keymap_macro_send(uint8_t id) {
     if (id >= DYNAMIC_KEYMAP_MACRO_COUNT) {
         return;
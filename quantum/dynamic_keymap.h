@@ -58,3 +58,9 @@ void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t
 void     dynamic_keymap_macro_reset(void);
 
 void dynamic_keymap_macro_send(uint8_t id);
+
+// Raw storage for the macros recorded with DYN_REC_START1/2, taken off
+// the end of the macro area when DYNAMIC_MACRO_EEPROM_SIZE is defined.
+uint16_t dynamic_keymap_recorded_macro_get_buffer_size(void);
+void     dynamic_keymap_recorded_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data);
+void     dynamic_keymap_recorded_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data);
@@ -22,6 +22,9 @@
 
 // for memcpy
 #include <string.h>
+#ifdef ENCODER_INTERRUPT
+#    include "ring_buffer.h"
+#endif
 
 #if !defined(ENCODER_RESOLUTIONS) && !defined(ENCODER_RESOLUTION)
 #    define ENCODER_RESOLUTION 4
@@ -52,17 +55,84 @@ static int8_t  encoder_pulses[NUMBER_OF_ENCODERS] = {0};
 
 #ifdef SPLIT_KEYBOARD
 // right half encoders come over as second set of encoders
-static uint8_t encoder_value[NUMBER_OF_ENCODERS * 2] = {0};
+#    define TOTAL_ENCODERS (NUMBER_OF_ENCODERS * 2)
 // row offsets for each hand
 static uint8_t thisHand, thatHand;
 #else
-static uint8_t encoder_value[NUMBER_OF_ENCODERS] = {0};
+#    define TOTAL_ENCODERS NUMBER_OF_ENCODERS
+#endif
+// Detents so far, counter clockwise positive. Only ever compared by difference, so wrapping around is fine.
+static uint16_t encoder_value[TOTAL_ENCODERS] = {0};
+
+#ifdef ENCODER_INTERRUPT
+#    ifndef ENCODER_QUEUE_SIZE
+#        define ENCODER_QUEUE_SIZE 32
+#    endif
+// Detents decoded by encoder_interrupt_handler(), each as (index << 1 | counter clockwise)
+RING_BUFFER_DEFINE(encoder_queue, uint8_t, ENCODER_QUEUE_SIZE);
+#endif
+
+#ifdef ENCODER_ACCELERATION
+#    ifndef ENCODER_ACCELERATION_TIMEOUT
+#        define ENCODER_ACCELERATION_TIMEOUT 100
+#    endif
+#    ifndef ENCODER_ACCELERATION_MAX
+#        define ENCODER_ACCELERATION_MAX 4
+#    endif
+static uint16_t encoder_last_detent[NUMBER_OF_ENCODERS] = {0};
+// Milliseconds between the last two detents of each encoder, as measured on the half it is connected to
+static uint16_t encoder_interval[TOTAL_ENCODERS] = {0};
+
+// Linear curve from 1x at ENCODER_ACCELERATION_TIMEOUT ms or more between detents, to ENCODER_ACCELERATION_MAX at 0
+__attribute__((weak)) uint8_t get_encoder_acceleration(uint8_t index, uint16_t interval) {
+    if (interval >= ENCODER_ACCELERATION_TIMEOUT) {
+        return 1;
+    }
+    return 1 + (uint32_t)(ENCODER_ACCELERATION_TIMEOUT - interval) * (ENCODER_ACCELERATION_MAX - 1) / ENCODER_ACCELERATION_TIMEOUT;
+}
+
+// Detents of local encoder i that arrived together are assumed to be evenly spread since the previous one
+static void encoder_measure_interval(uint8_t i, uint16_t detents) {
+    uint16_t now = timer_read();
+#    ifdef SPLIT_KEYBOARD
+    encoder_interval[i + thisHand] = TIMER_DIFF_16(now, encoder_last_detent[i]) / detents;
+#    else
+    encoder_interval[i] = TIMER_DIFF_16(now, encoder_last_detent[i]) / detents;
+#    endif
+    encoder_last_detent[i] = now;
+}
 #endif
 
 __attribute__((weak)) void encoder_update_user(int8_t index, bool clockwise) {}
 
 __attribute__((weak)) void encoder_update_kb(int8_t index, bool clockwise) { encoder_update_user(index, clockwise); }
 
+__attribute__((weak)) bool encoder_update_batch_user(uint8_t index, int16_t clicks) { return true; }
+
+__attribute__((weak)) bool encoder_update_batch_kb(uint8_t index, int16_t clicks) { return encoder_update_batch_user(index, clicks); }
+
+// Reports detents of encoder index, counted from both hands on split keyboards. Positive means counter clockwise.
+static void encoder_emit(uint8_t index, int16_t detents) {
+    encoder_value[index] += detents;
+
+    bool     clockwise = detents > 0 ? ENCODER_COUNTER_CLOCKWISE : ENCODER_CLOCKWISE;
+    uint16_t steps     = detents > 0 ? detents : -detents;
+#ifdef ENCODER_ACCELERATION
+    uint32_t accelerated = (uint32_t)steps * get_encoder_acceleration(index, encoder_interval[index]);
+    steps                = accelerated > INT16_MAX ? INT16_MAX : accelerated;
+#endif
+    if (!encoder_update_batch_kb(index, clockwise ? steps : -steps)) {
+        return;
+    }
+    while (steps--) {
+        encoder_update_kb(index, clockwise);
+    }
+}
+
+#if defined(ENCODER_INTERRUPT) && defined(PROTOCOL_CHIBIOS) && PAL_USE_CALLBACKS
+static void encoder_pad_callback(void *arg) { encoder_interrupt_handler((uint8_t)(uintptr_t)arg); }
+#endif
+
 void encoder_init(void) {
 #if defined(SPLIT_KEYBOARD) && defined(ENCODERS_PAD_A_RIGHT) && defined(ENCODERS_PAD_B_RIGHT)
     if (!isLeftHand) {
@@ -86,6 +156,12 @@ void encoder_init(void) {
         setPinInputHigh(encoders_pad_b[i]);
 
         encoder_state[i] = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+#if defined(ENCODER_INTERRUPT) && defined(PROTOCOL_CHIBIOS) && PAL_USE_CALLBACKS
+        palEnableLineEvent(encoders_pad_a[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palEnableLineEvent(encoders_pad_b[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoders_pad_a[i], encoder_pad_callback, (void *)(uintptr_t)i);
+        palSetLineCallback(encoders_pad_b[i], encoder_pad_callback, (void *)(uintptr_t)i);
+#endif
     }
 
 #ifdef SPLIT_KEYBOARD
@@ -94,9 +170,9 @@ void encoder_init(void) {
 #endif
 }
 
-static bool encoder_update(int8_t index, uint8_t state) {
-    bool    changed = false;
-    uint8_t i       = index;
+// Runs the quadrature decoder of local encoder i on its latest state, returns the detent completed if any
+static int8_t encoder_decode(uint8_t i, uint8_t state) {
+    int8_t detent = 0;
 
 #ifdef ENCODER_RESOLUTIONS
     int8_t resolution = encoder_resolutions[i];
@@ -104,23 +180,70 @@ static bool encoder_update(int8_t index, uint8_t state) {
     int8_t resolution = ENCODER_RESOLUTION;
 #endif
 
-#ifdef SPLIT_KEYBOARD
-    index += thisHand;
-#endif
     encoder_pulses[i] += encoder_LUT[state & 0xF];
     if (encoder_pulses[i] >= resolution) {
-        encoder_value[index]++;
-        changed = true;
-        encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
+        detent = 1;
     }
     if (encoder_pulses[i] <= -resolution) {  // direction is arbitrary here, but this clockwise
-        encoder_value[index]--;
-        changed = true;
-        encoder_update_kb(index, ENCODER_CLOCKWISE);
+        detent = -1;
     }
     encoder_pulses[i] %= resolution;
+    return detent;
+}
+
+#ifdef ENCODER_INTERRUPT
+void encoder_interrupt_handler(uint8_t index) {
+    if (index >= NUMBER_OF_ENCODERS) {
+        return;
+    }
+    encoder_state[index] <<= 2;
+    encoder_state[index] |= (readPin(encoders_pad_a[index]) << 0) | (readPin(encoders_pad_b[index]) << 1);
+
+    int8_t detent = encoder_decode(index, encoder_state[index]);
+    if (detent) {
+        // Dropped when full, which takes more than ENCODER_QUEUE_SIZE detents between two scans
+        encoder_queue_enqueue(index << 1 | (detent > 0));
+    }
+}
+
+bool encoder_read(void) {
+    int16_t detents[NUMBER_OF_ENCODERS] = {0};
+    uint8_t event;
+    bool    changed = false;
+
+    while (encoder_queue_dequeue(&event)) {
+        detents[event >> 1] += (event & 1) ? 1 : -1;
+    }
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        if (detents[i]) {
+#    ifdef ENCODER_ACCELERATION
+            encoder_measure_interval(i, detents[i] > 0 ? detents[i] : -detents[i]);
+#    endif
+#    ifdef SPLIT_KEYBOARD
+            encoder_emit(i + thisHand, detents[i]);
+#    else
+            encoder_emit(i, detents[i]);
+#    endif
+            changed = true;
+        }
+    }
     return changed;
 }
+#else
+static bool encoder_update(int8_t index, uint8_t state) {
+    int8_t detent = encoder_decode(index, state);
+    if (!detent) {
+        return false;
+    }
+#    ifdef ENCODER_ACCELERATION
+    encoder_measure_interval(index, 1);
+#    endif
+#    ifdef SPLIT_KEYBOARD
+    index += thisHand;
+#    endif
+    encoder_emit(index, detent);
+    return true;
+}
 
 bool encoder_read(void) {
     bool changed = false;
@@ -131,28 +254,46 @@ bool encoder_read(void) {
     }
     return changed;
 }
+#endif
 
 #ifdef SPLIT_KEYBOARD
 void last_encoder_activity_trigger(void);
 
-void encoder_state_raw(uint8_t* slave_state) { memcpy(slave_state, &encoder_value[thisHand], sizeof(uint8_t) * NUMBER_OF_ENCODERS); }
+void encoder_state_raw(encoder_sync_t* slave_state) {
+    uint32_t uptime = timer_read32() / 1000;
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        slave_state[i].count  = encoder_value[i + thisHand];
+        slave_state[i].uptime = uptime > UINT8_MAX ? UINT8_MAX : uptime;
+#    ifdef ENCODER_ACCELERATION
+        slave_state[i].interval = encoder_interval[i + thisHand];
+#    endif
+    }
+}
+
+void encoder_update_raw(encoder_sync_t* slave_state) {
+    static bool    synced       = false;
+    static uint8_t slave_uptime = 0;
+
+    // After either half restarts, the counts no longer follow on from the ones last seen, take them as they are
+    bool resync  = !synced || slave_state[0].uptime < slave_uptime;
+    synced       = true;
+    slave_uptime = slave_state[0].uptime;
 
-void encoder_update_raw(uint8_t* slave_state) {
     bool changed = false;
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
         uint8_t index = i + thatHand;
-        int8_t  delta = slave_state[i] - encoder_value[index];
-        while (delta > 0) {
-            delta--;
-            encoder_value[index]++;
-            changed = true;
-            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
+        if (resync) {
+            encoder_value[index] = slave_state[i].count;
+            continue;
         }
-        while (delta < 0) {
-            delta++;
-            encoder_value[index]--;
+        // The counters only wrap after 32767 detents between two transfers, and a failed transfer is caught up on by the next one
+        int16_t delta = slave_state[i].count - encoder_value[index];
+        if (delta) {
+#    ifdef ENCODER_ACCELERATION
+            encoder_interval[index] = slave_state[i].interval;
+#    endif
+            encoder_emit(index, delta);
             changed = true;
-            encoder_update_kb(index, ENCODER_CLOCKWISE);
         }
     }
 
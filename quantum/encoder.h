@@ -25,7 +25,30 @@ bool encoder_read(void);
 void encoder_update_kb(int8_t index, bool clockwise);
 void encoder_update_user(int8_t index, bool clockwise);
 
+// Called once with every detent read in one go, clicks is positive when clockwise. Return false to skip calling
+// encoder_update_kb() once per click.
+bool encoder_update_batch_kb(uint8_t index, int16_t clicks);
+bool encoder_update_batch_user(uint8_t index, int16_t clicks);
+
+#ifdef ENCODER_INTERRUPT
+// Samples both pads of local encoder index, to be called from a pin change interrupt on either pad
+void encoder_interrupt_handler(uint8_t index);
+#endif
+
+#ifdef ENCODER_ACCELERATION
+uint8_t get_encoder_acceleration(uint8_t index, uint16_t interval);
+#endif
+
 #ifdef SPLIT_KEYBOARD
-void encoder_state_raw(uint8_t* slave_state);
-void encoder_update_raw(uint8_t* slave_state);
+// What the slave half sends for each of its encoders
+typedef struct {
+    uint16_t count;   // detents so far, the master applies the difference to the previous count
+    uint8_t  uptime;  // seconds since the slave started, saturating, so the master notices when it restarts
+#    ifdef ENCODER_ACCELERATION
+    uint16_t interval;  // milliseconds between the last two detents
+#    endif
+} __attribute__((packed)) encoder_sync_t;
+
+void encoder_state_raw(encoder_sync_t* slave_state);
+void encoder_update_raw(encoder_sync_t* slave_state);
 #endif
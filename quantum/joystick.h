@@ -20,6 +20,23 @@
 
 #define JOYSTICK_RESOLUTION ((1L << (JOYSTICK_AXES_RESOLUTION - 1)) - 1)
 
+// number of ADC samples averaged for each reading, a power of two keeps the division cheap
+#ifndef JOYSTICK_OVERSAMPLE
+#    define JOYSTICK_OVERSAMPLE 1
+#elif JOYSTICK_OVERSAMPLE < 1 || JOYSTICK_OVERSAMPLE > 64
+#    error JOYSTICK_OVERSAMPLE must be between 1 and 64
+#endif
+
+// smoothing of successive readings, each one moves the axis 1 / 2^JOYSTICK_FILTER of the way, 0 disables it
+#ifndef JOYSTICK_FILTER
+#    define JOYSTICK_FILTER 0
+#endif
+
+// changes of an axis up to this many steps are not reported, 0 reports every change
+#ifndef JOYSTICK_DEADBAND
+#    define JOYSTICK_DEADBAND 0
+#endif
+
 // configure on input_pin of the joystick_axes array entry to JS_VIRTUAL_AXIS
 // to prevent it from being read from the ADC. This allows outputing forged axis value.
 //
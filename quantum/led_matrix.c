@@ -17,9 +17,6 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <stdint.h>
-#include <stdbool.h>
-#include "quantum.h"
 #include "led_matrix.h"
 #include "progmem.h"
 #include "config.h"
@@ -27,7 +24,41 @@
 #include <string.h>
 #include <math.h>
 
-led_eeconfig_t led_matrix_eeconfig;
+#include <lib/lib8tion/lib8tion.h>
+
+#ifndef LED_MATRIX_CENTER
+const point_t k_led_matrix_center = {112, 32};
+#else
+const point_t k_led_matrix_center = LED_MATRIX_CENTER;
+#endif
+
+#if !defined(LED_MATRIX_MAXIMUM_BRIGHTNESS) || LED_MATRIX_MAXIMUM_BRIGHTNESS > 255
+#    undef LED_MATRIX_MAXIMUM_BRIGHTNESS
+#    define LED_MATRIX_MAXIMUM_BRIGHTNESS 255
+#endif
+
+// Generic effect runners
+#include "led_matrix_runners/effect_runner_dx_dy.h"
+#include "led_matrix_runners/effect_runner_i.h"
+#include "led_matrix_runners/effect_runner_reactive.h"
+
+// ------------------------------------------
+// -----Begin led effect includes macros-----
+#define LED_MATRIX_EFFECT(name)
+#define LED_MATRIX_CUSTOM_EFFECT_IMPLS
+
+#include "led_matrix_animations/led_matrix_effects.inc"
+#ifdef LED_MATRIX_CUSTOM_KB
+#    include "led_matrix_kb.inc"
+#endif
+#ifdef LED_MATRIX_CUSTOM_USER
+#    include "led_matrix_user.inc"
+#endif
+
+#undef LED_MATRIX_CUSTOM_EFFECT_IMPLS
+#undef LED_MATRIX_EFFECT
+// -----End led effect includes macros-------
+// ------------------------------------------
 
 #ifndef MAX
 #    define MAX(X, Y) ((X) > (Y) ? (X) : (Y))
@@ -37,8 +68,12 @@ led_eeconfig_t led_matrix_eeconfig;
 #    define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
-#ifndef LED_DISABLE_AFTER_TIMEOUT
-#    define LED_DISABLE_AFTER_TIMEOUT 0
+#if defined(LED_DISABLE_AFTER_TIMEOUT) && !defined(LED_DISABLE_TIMEOUT)
+#    define LED_DISABLE_TIMEOUT (LED_DISABLE_AFTER_TIMEOUT * 60000UL)
+#endif
+
+#ifndef LED_DISABLE_TIMEOUT
+#    define LED_DISABLE_TIMEOUT 0
 #endif
 
 #ifndef LED_DISABLE_WHEN_USB_SUSPENDED
@@ -49,20 +84,24 @@ led_eeconfig_t led_matrix_eeconfig;
 #    define EECONFIG_LED_MATRIX EECONFIG_RGBLIGHT
 #endif
 
-#if !defined(LED_MATRIX_MAXIMUM_BRIGHTNESS) || LED_MATRIX_MAXIMUM_BRIGHTNESS > 255
-#    define LED_MATRIX_MAXIMUM_BRIGHTNESS 255
+#if !defined(LED_MATRIX_SPD_STEP)
+#    define LED_MATRIX_SPD_STEP 16
 #endif
 
-bool g_suspend_state = false;
-
-// Global tick at 20 Hz
-uint32_t g_tick = 0;
+#if !defined(LED_MATRIX_STARTUP_SPD)
+#    define LED_MATRIX_STARTUP_SPD UINT8_MAX / 2
+#endif
 
-// Ticks since this key was last hit.
-uint8_t g_key_hit[DRIVER_LED_TOTAL];
+// globals
+bool           g_suspend_state = false;
+led_eeconfig_t led_matrix_eeconfig;
+uint32_t       g_led_timer;
+#ifdef LED_MATRIX_FRAMEBUFFER_EFFECTS
+uint8_t g_led_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
+#endif  // LED_MATRIX_FRAMEBUFFER_EFFECTS
 
-// Ticks since any key was last hit.
-uint32_t g_any_key_hit = 0;
+// internals
+static lighting_task_t led_task = {.state = SYNCING, .params = {0, LED_FLAG_ALL, false}, .last_effect = UINT8_MAX, .last_enable = UINT8_MAX};
 
 uint32_t eeconfig_read_led_matrix(void) { return eeprom_read_dword(EECONFIG_LED_MATRIX); }
 
@@ -73,7 +112,8 @@ void eeconfig_update_led_matrix_default(void) {
     led_matrix_eeconfig.enable = 1;
     led_matrix_eeconfig.mode   = LED_MATRIX_UNIFORM_BRIGHTNESS;
     led_matrix_eeconfig.val    = 128;
-    led_matrix_eeconfig.speed  = 0;
+    led_matrix_eeconfig.speed  = LED_MATRIX_STARTUP_SPD;
+    led_matrix_eeconfig.layout = LED_MATRIX_EECONFIG_LAYOUT;
     eeconfig_update_led_matrix(led_matrix_eeconfig.raw);
 }
 
@@ -85,11 +125,10 @@ void eeconfig_debug_led_matrix(void) {
     dprintf("led_matrix_eeconfig.speed = %d\n", led_matrix_eeconfig.speed);
 }
 
-uint8_t g_last_led_hit[LED_HITS_TO_REMEMBER] = {255};
-uint8_t g_last_led_count                     = 0;
+__attribute__((weak)) uint8_t led_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i) { return 0; }
 
-uint8_t map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
-    uint8_t led_count = 0;
+uint8_t led_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
+    uint8_t led_count = led_matrix_map_row_column_to_led_kb(row, column, led_i);
     uint8_t led_index = g_led_config.matrix_co[row][column];
     if (led_index != NO_LED) {
         led_i[led_count] = led_index;
@@ -104,84 +143,120 @@ void led_matrix_set_index_value(int index, uint8_t value) { led_matrix_driver.se
 
 void led_matrix_set_index_value_all(uint8_t value) { led_matrix_driver.set_value_all(value); }
 
-bool process_led_matrix(uint16_t keycode, keyrecord_t *record) {
-    if (record->event.pressed) {
-        uint8_t led[8];
-        uint8_t led_count = map_row_column_to_led(record->event.key.row, record->event.key.col, led);
-        if (led_count > 0) {
-            for (uint8_t i = LED_HITS_TO_REMEMBER; i > 1; i--) {
-                g_last_led_hit[i - 1] = g_last_led_hit[i - 2];
-            }
-            g_last_led_hit[0] = led[0];
-            g_last_led_count  = MIN(LED_HITS_TO_REMEMBER, g_last_led_count + 1);
-        }
-        for (uint8_t i = 0; i < led_count; i++) g_key_hit[led[i]] = 0;
-        g_any_key_hit = 0;
-    } else {
-#ifdef LED_MATRIX_KEYRELEASES
-        uint8_t led[8];
-        uint8_t led_count = map_row_column_to_led(record->event.key.row, record->event.key.col, led);
-        for (uint8_t i = 0; i < led_count; i++) g_key_hit[led[i]] = 255;
-
-        g_any_key_hit = 255;
-#endif
-    }
-    return true;
-}
-
-void led_matrix_set_suspend_state(bool state) { g_suspend_state = state; }
-
-// All LEDs off
-void led_matrix_all_off(void) { led_matrix_set_index_value_all(0); }
-
-// Uniform brightness
-void led_matrix_uniform_brightness(void) { led_matrix_set_index_value_all(LED_MATRIX_MAXIMUM_BRIGHTNESS / BACKLIGHT_LEVELS * led_matrix_eeconfig.val); }
-
-void led_matrix_custom(void) {}
+void process_led_matrix(uint8_t row, uint8_t col, bool pressed) {
+    uint8_t led[LED_HITS_TO_REMEMBER];
+    uint8_t led_count = 0;
 
-void led_matrix_task(void) {
-    if (!led_matrix_eeconfig.enable) {
-        led_matrix_all_off();
-        led_matrix_indicators();
-        return;
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+#    if defined(LED_MATRIX_KEYRELEASES)
+    if (!pressed)
+#    elif defined(LED_MATRIX_KEYPRESSES)
+    if (pressed)
+#    endif  // defined(LED_MATRIX_KEYRELEASES)
+    {
+        led_count = led_matrix_map_row_column_to_led(row, col, led);
     }
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
 
-    g_tick++;
+    lighting_task_record_hits(&led_task, led, led_count);
 
-    if (g_any_key_hit < 0xFFFFFFFF) {
-        g_any_key_hit++;
+#if defined(LED_MATRIX_FRAMEBUFFER_EFFECTS) && !defined(DISABLE_LED_MATRIX_TYPING_HEATMAP)
+    if (led_matrix_eeconfig.mode == LED_MATRIX_TYPING_HEATMAP) {
+        process_led_matrix_typing_heatmap(row, col);
     }
+#endif  // defined(LED_MATRIX_FRAMEBUFFER_EFFECTS) && !defined(DISABLE_LED_MATRIX_TYPING_HEATMAP)
+}
 
-    for (int led = 0; led < DRIVER_LED_TOTAL; led++) {
-        if (g_key_hit[led] < 255) {
-            if (g_key_hit[led] == 254) g_last_led_count = MAX(g_last_led_count - 1, 0);
-            g_key_hit[led]++;
-        }
+static bool led_matrix_none(effect_params_t *params) {
+    if (!params->init) {
+        return false;
     }
 
-    // Ideally we would also stop sending zeros to the LED driver PWM buffers
-    // while suspended and just do a software shutdown. This is a cheap hack for now.
-    bool    suspend_backlight = ((g_suspend_state && LED_DISABLE_WHEN_USB_SUSPENDED) || (LED_DISABLE_AFTER_TIMEOUT > 0 && g_any_key_hit > LED_DISABLE_AFTER_TIMEOUT * 60 * 20));
-    uint8_t effect            = suspend_backlight ? 0 : led_matrix_eeconfig.mode;
+    led_matrix_set_index_value_all(0);
+    return false;
+}
+
+static void led_task_render(uint8_t effect) {
+    bool rendering = false;
+    lighting_task_render_begin(&led_task, effect, led_matrix_eeconfig.enable);
 
-    // this gets ticked at 20 Hz.
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
     switch (effect) {
-        case LED_MATRIX_UNIFORM_BRIGHTNESS:
-            led_matrix_uniform_brightness();
+        case LED_MATRIX_NONE:
+            rendering = led_matrix_none(&led_task.params);
             break;
-        default:
-            led_matrix_custom();
+
+// ---------------------------------------------
+// -----Begin led effect switch case macros-----
+#define LED_MATRIX_EFFECT(name, ...)          \
+    case LED_MATRIX_##name:                   \
+        rendering = name(&led_task.params); \
+        break;
+#include "led_matrix_animations/led_matrix_effects.inc"
+#undef LED_MATRIX_EFFECT
+
+#if defined(LED_MATRIX_CUSTOM_KB) || defined(LED_MATRIX_CUSTOM_USER)
+#    define LED_MATRIX_EFFECT(name, ...)          \
+        case LED_MATRIX_CUSTOM_##name:            \
+            rendering = name(&led_task.params); \
             break;
+#    ifdef LED_MATRIX_CUSTOM_KB
+#        include "led_matrix_kb.inc"
+#    endif
+#    ifdef LED_MATRIX_CUSTOM_USER
+#        include "led_matrix_user.inc"
+#    endif
+#    undef LED_MATRIX_EFFECT
+#endif
+            // -----End led effect switch case macros-------
+            // ---------------------------------------------
     }
 
-    if (!suspend_backlight) {
-        led_matrix_indicators();
-    }
+    lighting_task_render_end(&led_task, effect, rendering);
+}
+
+static void led_task_flush(uint8_t effect) {
+    lighting_task_flush(&led_task, effect, led_matrix_eeconfig.enable);
+
+    // update pwm buffers
+    led_matrix_update_pwm_buffers();
+}
+
+void led_matrix_task(void) {
+    lighting_task_timers(&led_task);
 
-    // Tell the LED driver to update its state
-    led_matrix_driver.flush();
+    // Ideally we would also stop sending zeros to the LED driver PWM buffers
+    // while suspended and just do a software shutdown. This is a cheap hack for now.
+    bool suspend_backlight =
+#if LED_DISABLE_WHEN_USB_SUSPENDED == true
+        g_suspend_state ||
+#endif  // LED_DISABLE_WHEN_USB_SUSPENDED == true
+#if LED_DISABLE_TIMEOUT > 0
+        (led_task.anykey_timer > (uint32_t)LED_DISABLE_TIMEOUT) ||
+#endif  // LED_DISABLE_TIMEOUT > 0
+        false;
+
+    uint8_t effect = suspend_backlight || !led_matrix_eeconfig.enable ? 0 : led_matrix_eeconfig.mode;
+
+    switch (led_task.state) {
+        case STARTING:
+            lighting_task_start(&led_task, &g_led_timer);
+            break;
+        case RENDERING:
+            led_task_render(effect);
+            if (effect) {
+                led_matrix_indicators();
+                led_matrix_indicators_advanced(&led_task.params);
+            }
+            break;
+        case FLUSHING:
+            led_task_flush(effect);
+            break;
+        case SYNCING:
+            lighting_task_sync(&led_task, g_led_timer, LED_MATRIX_LED_FLUSH_LIMIT);
+            break;
+    }
 }
 
 void led_matrix_indicators(void) {
@@ -193,22 +268,25 @@ __attribute__((weak)) void led_matrix_indicators_kb(void) {}
 
 __attribute__((weak)) void led_matrix_indicators_user(void) {}
 
-// void led_matrix_set_indicator_index(uint8_t *index, uint8_t row, uint8_t column)
-// {
-//  if (row >= MATRIX_ROWS)
-//  {
-//      // Special value, 255=none, 254=all
-//      *index = row;
-//  }
-//  else
-//  {
-//      // This needs updated to something like
-//      // uint8_t led[8];
-//      // uint8_t led_count = map_row_column_to_led(row, column, led);
-//      // for(uint8_t i = 0; i < led_count; i++)
-//      map_row_column_to_led(row, column, index);
-//  }
-// }
+void led_matrix_indicators_advanced(effect_params_t *params) {
+    /* special handling is needed for "params->iter", since it's already been incremented.
+     * See the matching comment in rgb_matrix_indicators_advanced().
+     */
+#if defined(LED_MATRIX_LED_PROCESS_LIMIT) && LED_MATRIX_LED_PROCESS_LIMIT > 0 && LED_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+    uint8_t min = LED_MATRIX_LED_PROCESS_LIMIT * (params->iter - 1);
+    uint8_t max = min + LED_MATRIX_LED_PROCESS_LIMIT;
+    if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
+#else
+    uint8_t min = 0;
+    uint8_t max = DRIVER_LED_TOTAL;
+#endif
+    led_matrix_indicators_advanced_kb(min, max);
+    led_matrix_indicators_advanced_user(min, max);
+}
+
+__attribute__((weak)) void led_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max) {}
+
+__attribute__((weak)) void led_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {}
 
 void led_matrix_init(void) {
     led_matrix_driver.init();
@@ -216,10 +294,7 @@ void led_matrix_init(void) {
     // Wait half a second for the driver to finish initializing
     wait_ms(500);
 
-    // clear the key hits
-    for (int led = 0; led < DRIVER_LED_TOTAL; led++) {
-        g_key_hit[led] = 255;
-    }
+    lighting_task_init(&led_task);
 
     if (!eeconfig_is_enabled()) {
         dprintf("led_matrix_init_drivers eeconfig is not enabled.\n");
@@ -235,9 +310,19 @@ void led_matrix_init(void) {
         led_matrix_eeconfig.raw = eeconfig_read_led_matrix();
     }
 
+    if (led_matrix_eeconfig.layout != LED_MATRIX_EECONFIG_LAYOUT) {
+        // Configs written before speed moved into the stored dword hold no speed, only the unused reserved bytes
+        dprintf("led_matrix_init_drivers led_matrix_eeconfig.layout = %d. Write default speed to EEPROM.\n", led_matrix_eeconfig.layout);
+        led_matrix_eeconfig.speed  = LED_MATRIX_STARTUP_SPD;
+        led_matrix_eeconfig.layout = LED_MATRIX_EECONFIG_LAYOUT;
+        eeconfig_update_led_matrix(led_matrix_eeconfig.raw);
+    }
+
     eeconfig_debug_led_matrix();  // display current eeprom values
 }
 
+void led_matrix_set_suspend_state(bool state) { g_suspend_state = state; }
+
 // Deals with the messy details of incrementing an integer
 static uint8_t increment(uint8_t value, uint8_t step, uint8_t min, uint8_t max) {
     int16_t new_value = value;
@@ -272,7 +357,7 @@ static uint8_t decrement(uint8_t value, uint8_t step, uint8_t min, uint8_t max)
 //     }
 // }
 
-uint32_t led_matrix_get_tick(void) { return g_tick; }
+uint32_t led_matrix_get_tick(void) { return g_led_timer; }
 
 void led_matrix_toggle(void) {
     led_matrix_eeconfig.enable ^= 1;
@@ -320,15 +405,24 @@ void led_matrix_decrease_val(void) {
 }
 
 void led_matrix_increase_speed(void) {
-    led_matrix_eeconfig.speed = increment(led_matrix_eeconfig.speed, 1, 0, 3);
+    led_matrix_eeconfig.speed = qadd8(led_matrix_eeconfig.speed, LED_MATRIX_SPD_STEP);
     eeconfig_update_led_matrix(led_matrix_eeconfig.raw);  // EECONFIG needs to be increased to support this
 }
 
 void led_matrix_decrease_speed(void) {
-    led_matrix_eeconfig.speed = decrement(led_matrix_eeconfig.speed, 1, 0, 3);
+    led_matrix_eeconfig.speed = qsub8(led_matrix_eeconfig.speed, LED_MATRIX_SPD_STEP);
     eeconfig_update_led_matrix(led_matrix_eeconfig.raw);  // EECONFIG needs to be increased to support this
 }
 
+uint8_t led_matrix_get_speed(void) { return led_matrix_eeconfig.speed; }
+
+void led_matrix_set_speed_noeeprom(uint8_t speed) { led_matrix_eeconfig.speed = speed; }
+
+void led_matrix_set_speed(uint8_t speed) {
+    led_matrix_set_speed_noeeprom(speed);
+    eeconfig_update_led_matrix(led_matrix_eeconfig.raw);
+}
+
 void led_matrix_mode(uint8_t mode, bool eeprom_write) {
     led_matrix_eeconfig.mode = mode;
     if (eeprom_write) {
@@ -336,6 +430,8 @@ void led_matrix_mode(uint8_t mode, bool eeprom_write) {
     }
 }
 
+void led_matrix_mode_noeeprom(uint8_t mode) { led_matrix_mode(mode, false); }
+
 uint8_t led_matrix_get_mode(void) { return led_matrix_eeconfig.mode; }
 
 void led_matrix_set_value_noeeprom(uint8_t val) { led_matrix_eeconfig.val = val; }
@@ -345,4 +441,8 @@ void led_matrix_set_value(uint8_t val) {
     eeconfig_update_led_matrix(led_matrix_eeconfig.raw);
 }
 
+led_flags_t led_matrix_get_flags(void) { return led_task.params.flags; }
+
+void led_matrix_set_flags(led_flags_t flags) { led_task.params.flags = flags; }
+
 void backlight_set(uint8_t val) { led_matrix_set_value(val); }
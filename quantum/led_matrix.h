@@ -19,15 +19,65 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "led_matrix_types.h"
+#include "lighting_matrix.h"
+#include "quantum.h"
 
 #ifndef BACKLIGHT_ENABLE
 #    error You must define BACKLIGHT_ENABLE with LED_MATRIX_ENABLE
 #endif
 
+#ifndef LED_MATRIX_LED_FLUSH_LIMIT
+#    define LED_MATRIX_LED_FLUSH_LIMIT 16
+#endif
+
+#ifndef LED_MATRIX_LED_PROCESS_LIMIT
+#    define LED_MATRIX_LED_PROCESS_LIMIT (DRIVER_LED_TOTAL + 4) / 5
+#endif
+
+#if defined(LED_MATRIX_LED_PROCESS_LIMIT) && LED_MATRIX_LED_PROCESS_LIMIT > 0 && LED_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#    define LED_MATRIX_USE_LIMITS(min, max)                        \
+        uint8_t min = LED_MATRIX_LED_PROCESS_LIMIT * params->iter; \
+        uint8_t max = min + LED_MATRIX_LED_PROCESS_LIMIT;          \
+        if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
+#else
+#    define LED_MATRIX_USE_LIMITS(min, max) \
+        uint8_t min = 0;                    \
+        uint8_t max = DRIVER_LED_TOTAL;
+#endif
+
+#define LED_MATRIX_INDICATOR_SET_VALUE(i, v) \
+    if (i >= led_min && i < led_max) {       \
+        led_matrix_set_index_value(i, v);    \
+    }
+
+#define LED_MATRIX_TEST_LED_FLAGS() \
+    if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
+
 enum led_matrix_effects {
-    LED_MATRIX_UNIFORM_BRIGHTNESS = 1,
-    // All new effects go above this line
+    LED_MATRIX_NONE = 0,
+
+// --------------------------------------
+// -----Begin led effect enum macros-----
+#define LED_MATRIX_EFFECT(name, ...) LED_MATRIX_##name,
+#include "led_matrix_animations/led_matrix_effects.inc"
+#undef LED_MATRIX_EFFECT
+
+#if defined(LED_MATRIX_CUSTOM_KB) || defined(LED_MATRIX_CUSTOM_USER)
+#    define LED_MATRIX_EFFECT(name, ...) LED_MATRIX_CUSTOM_##name,
+#    ifdef LED_MATRIX_CUSTOM_KB
+#        include "led_matrix_kb.inc"
+#    endif
+#    ifdef LED_MATRIX_CUSTOM_USER
+#        include "led_matrix_user.inc"
+#    endif
+#    undef LED_MATRIX_EFFECT
+#endif
+    // --------------------------------------
+    // -----End led effect enum macros-------
+
     LED_MATRIX_EFFECT_MAX
 };
 
@@ -35,11 +85,18 @@ void led_matrix_set_index_value(int index, uint8_t value);
 void led_matrix_set_index_value_all(uint8_t value);
 
 // This runs after another backlight effect and replaces
-// colors already set
+// values already set
 void led_matrix_indicators(void);
 void led_matrix_indicators_kb(void);
 void led_matrix_indicators_user(void);
 
+uint8_t led_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i);
+uint8_t led_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i);
+
+void led_matrix_indicators_advanced(effect_params_t *params);
+void led_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max);
+void led_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max);
+
 void led_matrix_init(void);
 void led_matrix_setup_drivers(void);
 
@@ -54,26 +111,32 @@ void led_matrix_task(void);
 // If the buffer is dirty, it will update the driver with the buffer.
 void led_matrix_update_pwm_buffers(void);
 
-bool process_led_matrix(uint16_t keycode, keyrecord_t *record);
+void process_led_matrix(uint8_t row, uint8_t col, bool pressed);
 
+// Milliseconds of animation time, as used by the effects (was a 20Hz tick count)
 uint32_t led_matrix_get_tick(void);
 
-void    led_matrix_toggle(void);
-void    led_matrix_enable(void);
-void    led_matrix_enable_noeeprom(void);
-void    led_matrix_disable(void);
-void    led_matrix_disable_noeeprom(void);
-void    led_matrix_step(void);
-void    led_matrix_step_reverse(void);
-void    led_matrix_increase_val(void);
-void    led_matrix_decrease_val(void);
-void    led_matrix_increase_speed(void);
-void    led_matrix_decrease_speed(void);
-void    led_matrix_mode(uint8_t mode, bool eeprom_write);
-void    led_matrix_mode_noeeprom(uint8_t mode);
-uint8_t led_matrix_get_mode(void);
-void    led_matrix_set_value(uint8_t mode);
-void    led_matrix_set_value_noeeprom(uint8_t mode);
+void        led_matrix_toggle(void);
+void        led_matrix_enable(void);
+void        led_matrix_enable_noeeprom(void);
+void        led_matrix_disable(void);
+void        led_matrix_disable_noeeprom(void);
+void        led_matrix_step(void);
+void        led_matrix_step_reverse(void);
+void        led_matrix_increase_val(void);
+void        led_matrix_decrease_val(void);
+void        led_matrix_increase_speed(void);
+void        led_matrix_decrease_speed(void);
+void        led_matrix_mode(uint8_t mode, bool eeprom_write);
+void        led_matrix_mode_noeeprom(uint8_t mode);
+uint8_t     led_matrix_get_mode(void);
+void        led_matrix_set_value(uint8_t mode);
+void        led_matrix_set_value_noeeprom(uint8_t mode);
+uint8_t     led_matrix_get_speed(void);
+void        led_matrix_set_speed(uint8_t speed);
+void        led_matrix_set_speed_noeeprom(uint8_t speed);
+led_flags_t led_matrix_get_flags(void);
+void        led_matrix_set_flags(led_flags_t flags);
 
 typedef struct {
     /* Perform any initialisation required for the other driver functions to work. */
@@ -91,4 +154,8 @@ extern const led_matrix_driver_t led_matrix_driver;
 
 extern led_eeconfig_t led_matrix_eeconfig;
 
-extern led_config_t g_led_config;
+extern bool     g_suspend_state;
+extern uint32_t g_led_timer;
+#ifdef LED_MATRIX_FRAMEBUFFER_EFFECTS
+extern uint8_t g_led_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
+#endif
@@ -0,0 +1,18 @@
+#ifndef DISABLE_LED_MATRIX_BREATHING
+LED_MATRIX_EFFECT(BREATHING)
+#    ifdef LED_MATRIX_CUSTOM_EFFECT_IMPLS
+
+bool BREATHING(effect_params_t* params) {
+    LED_MATRIX_USE_LIMITS(led_min, led_max);
+
+    uint16_t time = scale16by8(g_led_timer, led_matrix_eeconfig.speed / 8);
+    uint8_t  val  = scale8(abs8(sin8(time) - 128) * 2, led_matrix_eeconfig.val);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_MATRIX_TEST_LED_FLAGS();
+        led_matrix_set_index_value(i, val);
+    }
+    return led_max < DRIVER_LED_TOTAL;
+}
+
+#    endif  // LED_MATRIX_CUSTOM_EFFECT_IMPLS
+#endif      // DISABLE_LED_MATRIX_BREATHING
@@ -0,0 +1,15 @@
+LED_MATRIX_EFFECT(UNIFORM_BRIGHTNESS)
+#ifdef LED_MATRIX_CUSTOM_EFFECT_IMPLS
+
+bool UNIFORM_BRIGHTNESS(effect_params_t* params) {
+    LED_MATRIX_USE_LIMITS(led_min, led_max);
+
+    uint8_t val = LED_MATRIX_MAXIMUM_BRIGHTNESS / BACKLIGHT_LEVELS * led_matrix_eeconfig.val;
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_MATRIX_TEST_LED_FLAGS();
+        led_matrix_set_index_value(i, val);
+    }
+    return led_max < DRIVER_LED_TOTAL;
+}
+
+#endif  // LED_MATRIX_CUSTOM_EFFECT_IMPLS
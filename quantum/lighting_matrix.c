@@ -0,0 +1,136 @@
+/* Copyright 2017 Jason Williams
+ * Copyright 2017 Jack Humbert
+ * Copyright 2018 Yiancar
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lighting_matrix.h"
+#include "sync_timer.h"
+#include <string.h>
+
+#ifdef LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+last_hit_t g_last_hit_tracker;
+#endif  // LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+
+void lighting_task_init(lighting_task_t *task) {
+#ifdef LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+    g_last_hit_tracker.count = 0;
+    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
+        g_last_hit_tracker.tick[i] = UINT16_MAX;
+    }
+
+    task->hit_buffer.count = 0;
+    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
+        task->hit_buffer.tick[i] = UINT16_MAX;
+    }
+#endif  // LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+}
+
+void lighting_task_record_hits(lighting_task_t *task, const uint8_t *led, uint8_t led_count) {
+    task->anykey_timer = 0;
+
+#ifdef LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+    last_hit_t *hits = &task->hit_buffer;
+
+    if (hits->count + led_count > LED_HITS_TO_REMEMBER) {
+        memcpy(&hits->x[0], &hits->x[led_count], LED_HITS_TO_REMEMBER - led_count);
+        memcpy(&hits->y[0], &hits->y[led_count], LED_HITS_TO_REMEMBER - led_count);
+        memcpy(&hits->tick[0], &hits->tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2);  // 16 bit
+        memcpy(&hits->index[0], &hits->index[led_count], LED_HITS_TO_REMEMBER - led_count);
+        hits->count--;
+    }
+
+    for (uint8_t i = 0; i < led_count; i++) {
+        uint8_t index      = hits->count;
+        hits->x[index]     = g_led_config.point[led[i]].x;
+        hits->y[index]     = g_led_config.point[led[i]].y;
+        hits->index[index] = led[i];
+        hits->tick[index]  = 0;
+        hits->count++;
+    }
+#endif  // LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+}
+
+void lighting_task_timers(lighting_task_t *task) {
+    uint32_t deltaTime = sync_timer_elapsed32(task->timer_buffer);
+    task->timer_buffer = sync_timer_read32();
+
+    // Update double buffer timers
+    if (task->anykey_timer < UINT32_MAX) {
+        if (UINT32_MAX - deltaTime < task->anykey_timer) {
+            task->anykey_timer = UINT32_MAX;
+        } else {
+            task->anykey_timer += deltaTime;
+        }
+    }
+
+    // Update double buffer last hit timers
+#ifdef LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+    uint8_t count = task->hit_buffer.count;
+    for (uint8_t i = 0; i < count; ++i) {
+        if (UINT16_MAX - deltaTime < task->hit_buffer.tick[i]) {
+            task->hit_buffer.count--;
+            continue;
+        }
+        task->hit_buffer.tick[i] += deltaTime;
+    }
+#endif  // LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+}
+
+void lighting_task_sync(lighting_task_t *task, uint32_t frame_timer, uint32_t flush_limit) {
+    // next task
+    if (sync_timer_elapsed32(frame_timer) >= flush_limit) task->state = STARTING;
+}
+
+void lighting_task_start(lighting_task_t *task, uint32_t *frame_timer) {
+    // reset iter
+    task->params.iter = 0;
+
+    // update double buffers
+    *frame_timer = task->timer_buffer;
+#ifdef LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+    g_last_hit_tracker = task->hit_buffer;
+#endif  // LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+
+    // next task
+    task->state = RENDERING;
+}
+
+void lighting_task_render_begin(lighting_task_t *task, uint8_t effect, uint8_t enable) {
+    // effects redo their one-off setup whenever the mode or enable state changed since the last flush
+    task->params.init = (effect != task->last_effect) || (enable != task->last_enable);
+}
+
+void lighting_task_render_end(lighting_task_t *task, uint8_t effect, bool rendering) {
+    task->params.iter++;
+
+    // next task
+    if (!rendering) {
+        task->state = FLUSHING;
+        if (!task->params.init && effect == 0) {
+            // We only need to flush once if we are the NONE effect
+            task->state = SYNCING;
+        }
+    }
+}
+
+void lighting_task_flush(lighting_task_t *task, uint8_t effect, uint8_t enable) {
+    // update last trackers after the first full render so we can init over several frames
+    task->last_effect = effect;
+    task->last_enable = enable;
+
+    // next task
+    task->state = SYNCING;
+}
@@ -0,0 +1,43 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lighting_matrix_types.h"
+
+/* Render pipeline shared by rgb_matrix and led_matrix.
+ *
+ * Each driver keeps one lighting_task_t and steps it from its own task function: STARTING latches the
+ * timers and hit tracker for the frame, RENDERING runs the current effect over a slice of the LEDs per
+ * call, FLUSHING pushes the driver buffers out and SYNCING waits for the flush limit to pass.
+ */
+
+extern led_config_t g_led_config;
+#ifdef LIGHTING_MATRIX_KEYREACTIVE_ENABLED
+extern last_hit_t g_last_hit_tracker;
+#endif
+
+void lighting_task_init(lighting_task_t *task);
+void lighting_task_record_hits(lighting_task_t *task, const uint8_t *led, uint8_t led_count);
+
+void lighting_task_timers(lighting_task_t *task);
+void lighting_task_sync(lighting_task_t *task, uint32_t frame_timer, uint32_t flush_limit);
+void lighting_task_start(lighting_task_t *task, uint32_t *frame_timer);
+void lighting_task_render_begin(lighting_task_t *task, uint8_t effect, uint8_t enable);
+void lighting_task_render_end(lighting_task_t *task, uint8_t effect, bool rendering);
+void lighting_task_flush(lighting_task_t *task, uint8_t effect, uint8_t enable);
@@ -16,11 +16,13 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include "keycode.h"
 #include "host.h"
 #include "timer.h"
 #include "print.h"
 #include "debug.h"
+#include "progmem.h"
 #include "mousekey.h"
 
 inline int8_t times_inv_sqrt2(int8_t x) {
@@ -40,7 +42,213 @@ static uint8_t        mousekey_wheel_repeat = 0;
 static uint16_t mouse_timer = 0;
 #endif
 
-#ifndef MK_3_SPEED
+#if defined(MK_PHYSICS)
+
+static uint16_t last_timer_c = 0;
+static uint16_t last_timer_w = 0;
+
+/*
+ * Mouse keys physics
+ *
+ * Each axis integrates its speed over the time that really elapsed since the previous report into a fixed point
+ * position with 8 fractional bits. Only whole units are reported and the fraction carries over to the next report, so
+ * slow speeds and diagonals are not rounded away, and neither the scan rate nor MK_PHYSICS_INTERVAL changes how far
+ * the cursor travels. Speeds in units per second are interpolated from the profiles below, by how long the cursor
+ * (or the wheel) has been moving.
+ */
+static const uint16_t PROGMEM mk_cursor_profile[] = MK_PHYSICS_CURSOR_PROFILE;
+static const uint16_t PROGMEM mk_wheel_profile[]  = MK_PHYSICS_WHEEL_PROFILE;
+
+#    define MK_PROFILE_LENGTH(profile) (sizeof(profile) / sizeof((profile)[0]))
+_Static_assert(MK_PROFILE_LENGTH(mk_cursor_profile) > 0 && MK_PROFILE_LENGTH(mk_cursor_profile) <= UINT8_MAX, "MK_PHYSICS_CURSOR_PROFILE needs 1 to 255 entries");
+_Static_assert(MK_PROFILE_LENGTH(mk_wheel_profile) > 0 && MK_PROFILE_LENGTH(mk_wheel_profile) <= UINT8_MAX, "MK_PHYSICS_WHEEL_PROFILE needs 1 to 255 entries");
+
+enum { mk_axis_x, mk_axis_y, mk_axis_v, mk_axis_h, mk_axis_COUNT };
+
+typedef struct {
+    int8_t  direction;  // -1, 0 or 1, from the movement keys held
+    int32_t position;   // movement not reported yet, in 1/256 units
+} mk_axis_t;
+
+static mk_axis_t mk_axes[mk_axis_COUNT];
+static uint32_t  mk_cursor_start = 0;
+static uint32_t  mk_wheel_start  = 0;
+static uint32_t  mk_last_update  = 0;
+
+static bool mk_axes_moving(uint8_t first, uint8_t count) {
+    for (uint8_t i = first; i < first + count; i++) {
+        // Released axes still count while they have whole units left to report
+        if (mk_axes[i].direction || mk_axes[i].position >= 256 || mk_axes[i].position <= -256) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint16_t mk_profile_speed(const uint16_t *profile, uint8_t length, uint16_t step, uint32_t held) {
+    if (mousekey_accel & (1 << 0)) {
+        return pgm_read_word(&profile[0]);
+    } else if (mousekey_accel & (1 << 1)) {
+        return pgm_read_word(&profile[length - 1]) / 2;
+    } else if (mousekey_accel & (1 << 2)) {
+        return pgm_read_word(&profile[length - 1]);
+    }
+
+    uint32_t index = held / step;
+    if (index >= length - 1u) {
+        return pgm_read_word(&profile[length - 1]);
+    }
+    int32_t from = pgm_read_word(&profile[index]);
+    int32_t to   = pgm_read_word(&profile[index + 1]);
+    return from + (to - from) * (int32_t)(held % step) / step;
+}
+
+static void mk_integrate(mk_axis_t *a, mk_axis_t *b, uint16_t speed, uint8_t elapsed) {
+    if (a->direction && b->direction) {
+        // 181/256 is pretty close to 1/sqrt(2), and the fraction is kept rather than truncated
+        speed = ((uint32_t)speed * 181) >> 8;
+    }
+    // units per second times milliseconds, times 256/1000 for the fixed point position
+    int32_t distance = ((uint32_t)speed * elapsed * 32) / 125;
+    a->position += a->direction * distance;
+    b->position += b->direction * distance;
+}
+
+static int16_t mk_take_units(mk_axis_t *axis, int16_t max) {
+    int32_t units = axis->position / 256;
+    if (units > max) {
+        units = max;
+    } else if (units < -max) {
+        units = -max;
+    }
+    axis->position -= units * 256;
+    // Motion beyond what a report can carry is dropped, rather than saved up until the key is released
+    if (axis->position > (int32_t)max * 256) {
+        axis->position = (int32_t)max * 256;
+    } else if (axis->position < -(int32_t)max * 256) {
+        axis->position = -(int32_t)max * 256;
+    }
+    return units;
+}
+
+void mousekey_task(void) {
+    bool cursor = mk_axes_moving(mk_axis_x, 2);
+    bool wheel  = mk_axes_moving(mk_axis_v, 2);
+    if (!cursor && !wheel) {
+        return;
+    }
+
+    uint32_t now     = timer_read32();
+    uint32_t elapsed = now - mk_last_update;
+    if (elapsed < MK_PHYSICS_INTERVAL) {
+        return;
+    }
+    mk_last_update = now;
+    // A stalled main loop should not throw the cursor across the screen once it catches up
+    if (elapsed > UINT8_MAX) {
+        elapsed = UINT8_MAX;
+    }
+
+    // Speeds are sampled halfway through the interval, which integrates a linear ramp exactly
+    uint32_t middle = now - elapsed / 2;
+    if (cursor) {
+        uint16_t speed = mk_profile_speed(mk_cursor_profile, MK_PROFILE_LENGTH(mk_cursor_profile), MK_PHYSICS_CURSOR_STEP, middle - mk_cursor_start);
+        mk_integrate(&mk_axes[mk_axis_x], &mk_axes[mk_axis_y], speed, elapsed);
+        mouse_report.x = mk_take_units(&mk_axes[mk_axis_x], MOUSE_REPORT_XY_MAX);
+        mouse_report.y = mk_take_units(&mk_axes[mk_axis_y], MOUSE_REPORT_XY_MAX);
+    }
+    if (wheel) {
+        uint16_t speed = mk_profile_speed(mk_wheel_profile, MK_PROFILE_LENGTH(mk_wheel_profile), MK_PHYSICS_WHEEL_STEP, middle - mk_wheel_start);
+        mk_integrate(&mk_axes[mk_axis_v], &mk_axes[mk_axis_h], speed, elapsed);
+        mouse_report.v = mk_take_units(&mk_axes[mk_axis_v], 127);
+        mouse_report.h = mk_take_units(&mk_axes[mk_axis_h], 127);
+    }
+
+    if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) mousekey_send();
+    mouse_report.x = 0;
+    mouse_report.y = 0;
+    mouse_report.v = 0;
+    mouse_report.h = 0;
+}
+
+static void mk_axis_on(uint8_t axis, int8_t direction) {
+    uint32_t now = timer_read32();
+    if (!mk_axes_moving(mk_axis_x, mk_axis_COUNT)) {
+        mk_last_update = now;
+    }
+    if (axis < mk_axis_v && !mk_axes_moving(mk_axis_x, 2)) {
+        mk_cursor_start = now;
+    } else if (axis >= mk_axis_v && !mk_axes_moving(mk_axis_v, 2)) {
+        mk_wheel_start = now;
+    }
+    // A tap moves exactly one unit, holding the key carries on from there
+    mk_axes[axis].direction = direction;
+    mk_axes[axis].position  = direction * 256;
+}
+
+static void mk_axis_off(uint8_t axis, int8_t direction) {
+    if (mk_axes[axis].direction == direction) {
+        mk_axes[axis].direction = 0;
+        // Whole units are still reported, so a tap shorter than MK_PHYSICS_INTERVAL is not lost
+        mk_axes[axis].position = mk_axes[axis].position / 256 * 256;
+    }
+}
+
+void mousekey_on(uint8_t code) {
+    if (code == KC_MS_UP)
+        mk_axis_on(mk_axis_y, -1);
+    else if (code == KC_MS_DOWN)
+        mk_axis_on(mk_axis_y, 1);
+    else if (code == KC_MS_LEFT)
+        mk_axis_on(mk_axis_x, -1);
+    else if (code == KC_MS_RIGHT)
+        mk_axis_on(mk_axis_x, 1);
+    else if (code == KC_MS_WH_UP)
+        mk_axis_on(mk_axis_v, 1);
+    else if (code == KC_MS_WH_DOWN)
+        mk_axis_on(mk_axis_v, -1);
+    else if (code == KC_MS_WH_LEFT)
+        mk_axis_on(mk_axis_h, -1);
+    else if (code == KC_MS_WH_RIGHT)
+        mk_axis_on(mk_axis_h, 1);
+    else if (IS_MOUSEKEY_BUTTON(code))
+        mouse_report.buttons |= 1 << (code - KC_MS_BTN1);
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel |= (1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel |= (1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel |= (1 << 2);
+}
+
+void mousekey_off(uint8_t code) {
+    if (code == KC_MS_UP)
+        mk_axis_off(mk_axis_y, -1);
+    else if (code == KC_MS_DOWN)
+        mk_axis_off(mk_axis_y, 1);
+    else if (code == KC_MS_LEFT)
+        mk_axis_off(mk_axis_x, -1);
+    else if (code == KC_MS_RIGHT)
+        mk_axis_off(mk_axis_x, 1);
+    else if (code == KC_MS_WH_UP)
+        mk_axis_off(mk_axis_v, 1);
+    else if (code == KC_MS_WH_DOWN)
+        mk_axis_off(mk_axis_v, -1);
+    else if (code == KC_MS_WH_LEFT)
+        mk_axis_off(mk_axis_h, -1);
+    else if (code == KC_MS_WH_RIGHT)
+        mk_axis_off(mk_axis_h, 1);
+    else if (IS_MOUSEKEY_BUTTON(code))
+        mouse_report.buttons &= ~(1 << (code - KC_MS_BTN1));
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel &= ~(1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel &= ~(1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel &= ~(1 << 2);
+}
+
+#elif !defined(MK_3_SPEED)
 
 static uint16_t last_timer_c = 0;
 static uint16_t last_timer_w = 0;
@@ -322,7 +530,7 @@ void mousekey_off(uint8_t code) {
     if (mouse_report.v == 0 && mouse_report.h == 0) mousekey_wheel_repeat = 0;
 }
 
-#else /* #ifndef MK_3_SPEED */
+#else /* #if defined(MK_PHYSICS) */
 
 enum { mkspd_unmod, mkspd_0, mkspd_1, mkspd_2, mkspd_COUNT };
 #    ifndef MK_MOMENTARY_ACCEL
@@ -451,7 +659,7 @@ void mousekey_off(uint8_t code) {
 #    endif
 }
 
-#endif /* #ifndef MK_3_SPEED */
+#endif /* #if defined(MK_PHYSICS) */
 
 void mousekey_send(void) {
     mousekey_debug();
@@ -466,6 +674,9 @@ void mousekey_clear(void) {
     mousekey_repeat       = 0;
     mousekey_wheel_repeat = 0;
     mousekey_accel        = 0;
+#ifdef MK_PHYSICS
+    memset(mk_axes, 0, sizeof(mk_axes));
+#endif
 }
 
 static void mousekey_debug(void) {
@@ -157,6 +157,39 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #endif /* #ifndef MK_3_SPEED */
 
+#ifdef MK_PHYSICS
+
+#    if defined(MK_3_SPEED) || defined(MK_COMBINED) || defined(MK_KINETIC_SPEED)
+#        error MK_PHYSICS cannot be combined with another mouse keys mode
+#    endif
+
+/* milliseconds between reports, there is no point in sending them faster than the host polls */
+#    ifndef MK_PHYSICS_INTERVAL
+#        ifdef USB_POLLING_INTERVAL_MS
+#            define MK_PHYSICS_INTERVAL USB_POLLING_INTERVAL_MS
+#        else
+#            define MK_PHYSICS_INTERVAL 10
+#        endif
+#    endif
+/* cursor speeds in pixels per second, one every MK_PHYSICS_CURSOR_STEP milliseconds of movement */
+#    ifndef MK_PHYSICS_CURSOR_PROFILE
+#        define MK_PHYSICS_CURSOR_PROFILE \
+            { 50, 100, 200, 300, 450, 600, 800, 1000 }
+#    endif
+#    ifndef MK_PHYSICS_CURSOR_STEP
+#        define MK_PHYSICS_CURSOR_STEP 100
+#    endif
+/* wheel speeds in scroll steps per second, one every MK_PHYSICS_WHEEL_STEP milliseconds of movement */
+#    ifndef MK_PHYSICS_WHEEL_PROFILE
+#        define MK_PHYSICS_WHEEL_PROFILE \
+            { 8, 12, 16, 24, 32 }
+#    endif
+#    ifndef MK_PHYSICS_WHEEL_STEP
+#        define MK_PHYSICS_WHEEL_STEP 250
+#    endif
+
+#endif /* #ifdef MK_PHYSICS */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
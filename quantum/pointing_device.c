@@ -23,20 +23,80 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "debug.h"
 #include "pointing_device.h"
 
+#ifndef POINTING_DEVICE_SEND_INTERVAL
+#    define POINTING_DEVICE_SEND_INTERVAL 0
+#endif
+
 static report_mouse_t mouseReport = {};
 
+// Motion that has not fit into a report yet, in sensor counts
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t v;
+    int16_t h;
+} pending_motion_t;
+
+static pending_motion_t pendingMotion = {};
+
+static inline int16_t add_saturated(int16_t a, int16_t b) {
+    int32_t sum = (int32_t)a + b;
+    return sum > INT16_MAX ? INT16_MAX : sum < -INT16_MAX ? -INT16_MAX : sum;
+}
+
+// As much of the pending motion as fits into one report field, only taken from it once the report is sent
+static inline int16_t clamp_motion(int16_t pending, int16_t min, int16_t max) { return pending < min ? min : pending > max ? max : pending; }
+
 __attribute__((weak)) bool has_mouse_report_changed(report_mouse_t new, report_mouse_t old) { return (new.buttons != old.buttons) || (new.x&& new.x != old.x) || (new.y&& new.y != old.y) || (new.h&& new.h != old.h) || (new.v&& new.v != old.v); }
 
 __attribute__((weak)) void pointing_device_init(void) {
     // initialize device, if that needs to be done.
 }
 
+void pointing_device_add_motion(int16_t x, int16_t y, int16_t v, int16_t h) {
+    pendingMotion.x = add_saturated(pendingMotion.x, x);
+    pendingMotion.y = add_saturated(pendingMotion.y, y);
+    pendingMotion.v = add_saturated(pendingMotion.v, v);
+    pendingMotion.h = add_saturated(pendingMotion.h, h);
+}
+
+bool pointing_device_has_pending_motion(void) { return pendingMotion.x || pendingMotion.y || pendingMotion.v || pendingMotion.h; }
+
 __attribute__((weak)) void pointing_device_send(void) {
     static report_mouse_t old_report = {};
+#if POINTING_DEVICE_SEND_INTERVAL > 0
+    static uint16_t last_send = 0;
+#endif
+
+    // Motion set directly in the report is merged with motion added since the last report, anything that doesn't fit
+    // within the report's range is carried over to the next ones rather than clipped
+    pointing_device_add_motion(mouseReport.x, mouseReport.y, mouseReport.v, mouseReport.h);
+
+#if POINTING_DEVICE_SEND_INTERVAL > 0
+    // Coalesce motion between host polls, button changes still go out immediately
+    if (mouseReport.buttons == old_report.buttons && timer_elapsed(last_send) < POINTING_DEVICE_SEND_INTERVAL) {
+        mouseReport.x = 0;
+        mouseReport.y = 0;
+        mouseReport.v = 0;
+        mouseReport.h = 0;
+        return;
+    }
+    last_send = timer_read();
+#endif
+
+    mouseReport.x = clamp_motion(pendingMotion.x, MOUSE_REPORT_XY_MIN, MOUSE_REPORT_XY_MAX);
+    mouseReport.y = clamp_motion(pendingMotion.y, MOUSE_REPORT_XY_MIN, MOUSE_REPORT_XY_MAX);
+    mouseReport.v = clamp_motion(pendingMotion.v, -127, 127);
+    mouseReport.h = clamp_motion(pendingMotion.h, -127, 127);
 
     // If you need to do other things, like debugging, this is the place to do it.
-    if (has_mouse_report_changed(mouseReport, old_report)) {
+    // Reports with motion always go out, so consecutive equal chunks of a large motion are not taken for repeats.
+    if (has_mouse_report_changed(mouseReport, old_report) || mouseReport.x || mouseReport.y || mouseReport.v || mouseReport.h) {
         host_mouse_send(&mouseReport);
+        pendingMotion.x -= mouseReport.x;
+        pendingMotion.y -= mouseReport.y;
+        pendingMotion.v -= mouseReport.v;
+        pendingMotion.h -= mouseReport.h;
     }
     // send it and 0 it out except for buttons, so those stay until they are explicity over-ridden using update_pointing_device
     mouseReport.x = 0;
@@ -48,8 +108,9 @@ __attribute__((weak)) void pointing_device_send(void) {
 
 __attribute__((weak)) void pointing_device_task(void) {
     // gather info and put it in:
-    // mouseReport.x = 127 max -127 min
-    // mouseReport.y = 127 max -127 min
+    // mouseReport.x = 127 max -127 min, or 32767 max -32767 min with MOUSE_EXTENDED_REPORT
+    // mouseReport.y = 127 max -127 min, or 32767 max -32767 min with MOUSE_EXTENDED_REPORT
+    // or pointing_device_add_motion(x, y, v, h) for larger deltas, which are split over as many reports as needed
     // mouseReport.v = 127 max -127 min (scroll vertical)
     // mouseReport.h = 127 max -127 min (scroll horizontal)
     // mouseReport.buttons = 0x1F (decimal 31, binary 00011111) max (bitmask for mouse buttons 1-5, 1 is rightmost, 5 is leftmost) 0x00 min
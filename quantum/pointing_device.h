@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "host.h"
 #include "report.h"
 
@@ -26,4 +27,6 @@ void           pointing_device_task(void);
 void           pointing_device_send(void);
 report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t newMouseReport);
-bool           has_mouse_report_changed(report_mouse_t new, report_mouse_t old);
+bool           has_mouse_report_changed(report_mouse_t new_report, report_mouse_t old_report);
+void           pointing_device_add_motion(int16_t x, int16_t y, int16_t v, int16_t h);
+bool           pointing_device_has_pending_motion(void);
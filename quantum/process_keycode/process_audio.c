@@ -4,7 +4,7 @@
 #ifndef VOICE_CHANGE_SONG
 #    define VOICE_CHANGE_SONG SONG(VOICE_CHANGE_SOUND)
 #endif
-float voice_change_song[][2] = VOICE_CHANGE_SONG;
+SONG_NOTES(voice_change_song[]) = VOICE_CHANGE_SONG;
 
 #ifndef PITCH_STANDARD_A
 #    define PITCH_STANDARD_A 440.0f
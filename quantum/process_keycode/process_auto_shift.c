@@ -18,23 +18,126 @@
 
 #    include <stdbool.h>
 #    include <stdio.h>
+#    include <string.h>
 
 #    include "process_auto_shift.h"
 
-static uint16_t autoshift_time    = 0;
-static uint16_t autoshift_timeout = AUTO_SHIFT_TIMEOUT;
-static uint16_t autoshift_lastkey = KC_NO;
+#    ifndef AUTO_SHIFT_QUEUE_SIZE
+#        define AUTO_SHIFT_QUEUE_SIZE 4
+#    endif
+
+// An auto-shiftable key that was pressed but not sent yet.
+typedef struct {
+    uint16_t keycode;
+    uint16_t time;
+    uint16_t timeout;
+    // How long the key was held, once released.
+    uint16_t held;
+    bool     released;
+} autoshift_pending_t;
+
+static uint16_t       autoshift_time          = 0;
+static uint16_t       autoshift_timeout       = AUTO_SHIFT_TIMEOUT;
+static uint16_t       autoshift_lastkey       = KC_NO;
+static deferred_token autoshift_timeout_token = INVALID_DEFERRED_TOKEN;
 static struct {
     // Whether autoshift is enabled.
     bool enabled : 1;
     // Whether the last auto-shifted key was released after the timeout.  This
     // is used to replicate the last key for a tap-then-hold.
     bool lastshifted : 1;
-    // Whether an auto-shiftable key has been pressed but not processed.
-    bool in_progress : 1;
-    // Whether the auto-shifted keypress has been registered.
-    bool holding_shift : 1;
-} autoshift_flags = {true, false, false, false};
+} autoshift_flags = {true, false};
+
+// Pending keys in the order they were pressed. Each is sent as soon as it is
+// decided and every key before it has been sent, so rolling over several
+// auto-shiftable keys neither reorders nor prematurely decides them.
+static autoshift_pending_t autoshift_queue[AUTO_SHIFT_QUEUE_SIZE];
+static uint8_t             autoshift_queue_count = 0;
+
+#    ifdef AUTO_SHIFT_TIMEOUT_PER_KEY
+__attribute__((weak)) uint16_t get_autoshift_key_timeout(uint16_t keycode, keyrecord_t *record) { return get_autoshift_timeout(); }
+#    endif
+
+/** \brief Fires once the autoshift timeout of the oldest pending key has passed */
+static uint32_t autoshift_timeout_callback(uint32_t trigger_time, void *cb_arg) {
+    autoshift_timeout_token = INVALID_DEFERRED_TOKEN;
+    autoshift_matrix_scan();
+    return 0;
+}
+
+/** \brief Schedules the timeout of the oldest pending key, which is always still held */
+static void autoshift_schedule(uint16_t now) {
+    cancel_deferred_exec(autoshift_timeout_token);
+    autoshift_timeout_token = INVALID_DEFERRED_TOKEN;
+    if (autoshift_queue_count) {
+        const uint16_t elapsed = TIMER_DIFF_16(now, autoshift_queue[0].time);
+        const uint16_t delay   = elapsed < autoshift_queue[0].timeout ? autoshift_queue[0].timeout - elapsed : 1;
+        autoshift_timeout_token = defer_exec(delay, autoshift_timeout_callback, NULL);
+    }
+}
+
+/** \brief Sends an auto-shiftable key, either tapped or left registered */
+static void autoshift_send(uint16_t keycode, bool shifted, bool tap) {
+    if (shifted) {
+        // Simulate pressing the shift key.
+        add_weak_mods(MOD_BIT(KC_LSFT));
+    } else {
+        del_weak_mods(MOD_BIT(KC_LSFT));
+    }
+    register_code(keycode);
+    autoshift_lastkey           = keycode;
+    autoshift_flags.lastshifted = shifted;
+
+    if (tap) {
+#    if TAP_CODE_DELAY > 0
+        wait_ms(TAP_CODE_DELAY);
+#    endif
+        unregister_code(keycode);
+        del_weak_mods(MOD_BIT(KC_LSFT));
+    }
+    send_keyboard_report();  // del_weak_mods doesn't send one.
+}
+
+/** \brief Sends the oldest pending key if it has been decided
+ *
+ * A released key is shifted if it was held for its timeout. A key still held
+ * past its timeout is sent shifted, and with keyrepeat it stays registered
+ * until released. With force set, a key still held within its timeout is sent
+ * unshifted, as when another key is pressed.
+ *
+ * \return Whether the key was sent.
+ */
+static bool autoshift_resolve_oldest(uint16_t now, bool force) {
+    const autoshift_pending_t *key = &autoshift_queue[0];
+    if (key->released) {
+        autoshift_send(key->keycode, key->held >= key->timeout, true);
+    } else if (TIMER_DIFF_16(now, key->time) >= key->timeout) {
+#    if defined(AUTO_SHIFT_REPEAT) && !defined(AUTO_SHIFT_NO_AUTO_REPEAT)
+        autoshift_send(key->keycode, true, false);
+#    else
+        autoshift_send(key->keycode, true, true);
+#    endif
+    } else if (force) {
+        autoshift_send(key->keycode, false, true);
+    } else {
+        return false;
+    }
+    autoshift_queue_count--;
+    memmove(&autoshift_queue[0], &autoshift_queue[1], autoshift_queue_count * sizeof(autoshift_pending_t));
+    // Roll the autoshift_time forward for detecting tap-and-hold.
+    autoshift_time = now;
+    return true;
+}
+
+/** \brief Sends the pending keys that have been decided, oldest first
+ *
+ * With flush set, every pending key is sent.
+ */
+static void autoshift_resolve(uint16_t now, bool flush) {
+    while (autoshift_queue_count && autoshift_resolve_oldest(now, flush)) {
+    }
+    autoshift_schedule(now);
+}
 
 /** \brief Record the press of an autoshiftable key
  *
@@ -55,7 +158,7 @@ static bool autoshift_press(uint16_t keycode, uint16_t now, keyrecord_t *record)
 #        ifndef AUTO_SHIFT_NO_AUTO_REPEAT
     if (!autoshift_flags.lastshifted) {
 #        endif
-        if (elapsed < TAPPING_TERM && keycode == autoshift_lastkey) {
+        if (autoshift_queue_count == 0 && elapsed < TAPPING_TERM && keycode == autoshift_lastkey) {
             // Allow a tap-then-hold for keyrepeat.
             if (!autoshift_flags.lastshifted) {
                 register_code(autoshift_lastkey);
@@ -71,10 +174,25 @@ static bool autoshift_press(uint16_t keycode, uint16_t now, keyrecord_t *record)
 #        endif
 #    endif
 
+    if (autoshift_queue_count == AUTO_SHIFT_QUEUE_SIZE) {
+        // Only the oldest key is decided early to make room, the others keep their timeouts.
+        autoshift_resolve_oldest(now, true);
+        autoshift_resolve(now, false);
+    }
+
     // Record the keycode so we can simulate it later.
-    autoshift_lastkey           = keycode;
-    autoshift_time              = now;
-    autoshift_flags.in_progress = true;
+    autoshift_queue[autoshift_queue_count++] = (autoshift_pending_t){
+        .keycode = keycode,
+        .time    = now,
+#    ifdef AUTO_SHIFT_TIMEOUT_PER_KEY
+        .timeout = get_autoshift_key_timeout(keycode, record),
+#    else
+        .timeout = autoshift_timeout,
+#    endif
+    };
+    if (autoshift_queue_count == 1) {
+        autoshift_schedule(now);
+    }
 
 #    if !defined(NO_ACTION_ONESHOT) && !defined(NO_ACTION_TAPPING)
     clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
@@ -82,51 +200,29 @@ static bool autoshift_press(uint16_t keycode, uint16_t now, keyrecord_t *record)
     return false;
 }
 
-/** \brief Registers an autoshiftable key under the right conditions
+/** \brief Handles the release of an autoshiftable key
  *
- * If the autoshift delay has elapsed, register a shift and the key.
- *
- * If the autoshift key is released before the delay has elapsed, register the
- * key without a shift.
+ * A pending key is marked released and sent once every key before it has been.
+ * Otherwise the key was already sent and held for keyrepeat, so release it.
  */
-static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
-    // Called on key down with KC_NO, auto-shifted key up, and timeout.
-    if (autoshift_flags.in_progress) {
-        // Process the auto-shiftable key.
-        autoshift_flags.in_progress = false;
-
-        // Time since the initial press was recorded.
-        const uint16_t elapsed = TIMER_DIFF_16(now, autoshift_time);
-        if (elapsed < autoshift_timeout) {
-            register_code(autoshift_lastkey);
-            autoshift_flags.lastshifted = false;
-        } else {
-            // Simulate pressing the shift key.
-            add_weak_mods(MOD_BIT(KC_LSFT));
-            register_code(autoshift_lastkey);
-            autoshift_flags.lastshifted = true;
-#    if defined(AUTO_SHIFT_REPEAT) && !defined(AUTO_SHIFT_NO_AUTO_REPEAT)
-            if (matrix_trigger) {
-                // Prevents release.
-                return;
-            }
-#    endif
+static void autoshift_release(uint16_t keycode, uint16_t now) {
+    for (uint8_t i = 0; i < autoshift_queue_count; i++) {
+        autoshift_pending_t *key = &autoshift_queue[i];
+        if (key->keycode == keycode && !key->released) {
+            key->released = true;
+            key->held     = TIMER_DIFF_16(now, key->time);
+            autoshift_resolve(now, false);
+            return;
         }
+    }
 
-#    if TAP_CODE_DELAY > 0
-        wait_ms(TAP_CODE_DELAY);
-#    endif
-        unregister_code(autoshift_lastkey);
+    // Release after keyrepeat.
+    unregister_code(keycode);
+    if (keycode == autoshift_lastkey) {
+        // This will only fire when the key was the last auto-shiftable
+        // pressed. That prevents aaaaBBBB then releasing a from unshifting
+        // later Bs (if B wasn't auto-shiftable).
         del_weak_mods(MOD_BIT(KC_LSFT));
-    } else {
-        // Release after keyrepeat.
-        unregister_code(keycode);
-        if (keycode == autoshift_lastkey) {
-            // This will only fire when the key was the last auto-shiftable
-            // pressed. That prevents aaaaBBBB then releasing a from unshifting
-            // later Bs (if B wasn't auto-shiftable).
-            del_weak_mods(MOD_BIT(KC_LSFT));
-        }
     }
     send_keyboard_report();  // del_weak_mods doesn't send one.
     // Roll the autoshift_time forward for detecting tap-and-hold.
@@ -135,18 +231,28 @@ static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
 
 /** \brief Simulates auto-shifted key releases when timeout is hit
  *
- *  Can be called from \c matrix_scan_user so that auto-shifted keys are sent
- *  immediately after the timeout has expired, rather than waiting for the key
- *  to be released.
+ *  Runs from a deferred callback scheduled for the oldest pending key, so
+ *  auto-shifted keys are sent immediately after the timeout has expired rather
+ *  than waiting for the key to be released.
  */
-void autoshift_matrix_scan(void) {
-    if (autoshift_flags.in_progress) {
-        const uint16_t now     = timer_read();
-        const uint16_t elapsed = TIMER_DIFF_16(now, autoshift_time);
-        if (elapsed >= autoshift_timeout) {
-            autoshift_end(autoshift_lastkey, now, true);
-        }
+void autoshift_matrix_scan(void) { autoshift_resolve(timer_read(), false); }
+
+static bool is_autoshift_key(uint16_t keycode) {
+    switch (keycode) {
+#    ifndef NO_AUTO_SHIFT_ALPHA
+        case KC_A ... KC_Z:
+#    endif
+#    ifndef NO_AUTO_SHIFT_NUMERIC
+        case KC_1 ... KC_0:
+#    endif
+#    ifndef NO_AUTO_SHIFT_SPECIAL
+        case KC_TAB:
+        case KC_MINUS ... KC_SLASH:
+        case KC_NONUS_BSLASH:
+#    endif
+            return true;
     }
+    return false;
 }
 
 void autoshift_toggle(void) {
@@ -183,10 +289,14 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
     const uint16_t now = timer_read();
 
     if (record->event.pressed) {
-        if (autoshift_flags.in_progress) {
-            // Evaluate previous key if there is one. Doing this elsewhere is
-            // more complicated and easier to break.
-            autoshift_end(KC_NO, now, false);
+        if (!autoshift_flags.enabled || !is_autoshift_key(keycode)
+#    ifndef AUTO_SHIFT_MODIFIERS
+            || get_mods()
+#    endif
+        ) {
+            // Evaluate the pending keys first, a key that is not queued can't
+            // be sent before them.
+            autoshift_resolve(now, true);
         }
         // For pressing another key while keyrepeating shifted autoshift.
         del_weak_mods(MOD_BIT(KC_LSFT));
@@ -217,24 +327,13 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
         }
     }
 
-    switch (keycode) {
-#    ifndef NO_AUTO_SHIFT_ALPHA
-        case KC_A ... KC_Z:
-#    endif
-#    ifndef NO_AUTO_SHIFT_NUMERIC
-        case KC_1 ... KC_0:
-#    endif
-#    ifndef NO_AUTO_SHIFT_SPECIAL
-        case KC_TAB:
-        case KC_MINUS ... KC_SLASH:
-        case KC_NONUS_BSLASH:
-#    endif
-            if (record->event.pressed) {
-                return autoshift_press(keycode, now, record);
-            } else {
-                autoshift_end(keycode, now, false);
-                return false;
-            }
+    if (is_autoshift_key(keycode)) {
+        if (record->event.pressed) {
+            return autoshift_press(keycode, now, record);
+        } else {
+            autoshift_release(keycode, now);
+            return false;
+        }
     }
     return true;
 }
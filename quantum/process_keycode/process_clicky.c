@@ -26,7 +26,12 @@ float clicky_freq = AUDIO_CLICKY_FREQ_DEFAULT;
 float clicky_rand = AUDIO_CLICKY_FREQ_RANDOMNESS;
 
 // the first "note" is an intentional delay; the 2nd and 3rd notes are the "clicky"
+#    ifdef AUDIO_COMPACT_SONGS
+// kept in RAM, since the pitches are randomized on every click
+musical_note_t clicky_song[] = {{NOTE_PITCH_FIXED(AUDIO_CLICKY_FREQ_MIN), AUDIO_CLICKY_DELAY_DURATION}, {NOTE_PITCH_FIXED(AUDIO_CLICKY_FREQ_DEFAULT), 3}, {NOTE_PITCH_FIXED(AUDIO_CLICKY_FREQ_DEFAULT), 1}};  // 3 and 1 --> durations
+#    else
 float clicky_song[][2] = {{AUDIO_CLICKY_FREQ_MIN, AUDIO_CLICKY_DELAY_DURATION}, {AUDIO_CLICKY_FREQ_DEFAULT, 3}, {AUDIO_CLICKY_FREQ_DEFAULT, 1}};  // 3 and 1 --> durations
+#    endif
 
 extern audio_config_t audio_config;
 
@@ -39,9 +44,15 @@ void clicky_play(void) {
 #    ifndef NO_MUSIC_MODE
     if (music_activated || midi_activated || !audio_config.enable) return;
 #    endif  // !NO_MUSIC_MODE
+#    ifdef AUDIO_COMPACT_SONGS
+    clicky_song[1].pitch = NOTE_PITCH_FIXED(2.0f * clicky_freq * (1.0f + clicky_rand * (((float)rand()) / ((float)(RAND_MAX)))));
+    clicky_song[2].pitch = NOTE_PITCH_FIXED(clicky_freq * (1.0f + clicky_rand * (((float)rand()) / ((float)(RAND_MAX)))));
+    audio_play_melody(clicky_song, NOTE_ARRAY_SIZE(clicky_song), false);
+#    else
     clicky_song[1][0] = 2.0f * clicky_freq * (1.0f + clicky_rand * (((float)rand()) / ((float)(RAND_MAX))));
     clicky_song[2][0] = clicky_freq * (1.0f + clicky_rand * (((float)rand()) / ((float)(RAND_MAX))));
     PLAY_SONG(clicky_song);
+#    endif
 }
 
 void clicky_freq_up(void) {
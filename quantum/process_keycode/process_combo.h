@@ -54,7 +54,6 @@ typedef struct {
 #endif
 
 bool process_combo(uint16_t keycode, keyrecord_t *record);
-void matrix_scan_combo(void);
 void process_combo_event(uint16_t combo_index, bool pressed);
 
 void combo_enable(void);
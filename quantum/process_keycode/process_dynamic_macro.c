@@ -17,6 +17,10 @@
 
 /* Author: Wojciech Siewierski < wojciech dot siewierski at onet dot pl > */
 #include "process_dynamic_macro.h"
+#include "ring_buffer.h"
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_MACRO_EEPROM_SIZE)
+#    include "dynamic_keymap.h"
+#endif
 
 // default feedback method
 void dynamic_macro_led_blink(void) {
@@ -44,13 +48,195 @@ __attribute__((weak)) void dynamic_macro_record_end_user(int8_t direction) { dyn
 #define DYNAMIC_MACRO_CURRENT_LENGTH(BEGIN, POINTER) ((int)(direction * ((POINTER) - (BEGIN))))
 #define DYNAMIC_MACRO_CURRENT_CAPACITY(BEGIN, END2) ((int)(direction * ((END2) - (BEGIN)) + 1))
 
+/* Each event is stored as
+ *
+ *   row, col, varint(delta << 2 | has_tap << 1 | pressed) [, tap]
+ *
+ * where delta is the time in milliseconds since the previous event
+ * and the varint holds 7 bits per byte, least significant first,
+ * with the top bit set on all but the last byte. Most events take 3
+ * bytes instead of a whole keyrecord_t.
+ *
+ * The bytes of an event are always written and read in the direction
+ * of its macro, so the second macro, which grows right-to-left, can
+ * be read back the same way it was written.
+ */
+#define DYNAMIC_MACRO_EVENT_MAX_SIZE 6
+
+#define DYNAMIC_MACRO_FLAG_PRESSED 0x01
+#define DYNAMIC_MACRO_FLAG_TAP 0x02
+
+static inline void dynamic_macro_put(uint8_t **pointer, int8_t direction, uint8_t value) {
+    **pointer = value;
+    *pointer += direction;
+}
+
+static inline uint8_t dynamic_macro_get(uint8_t **pointer, int8_t direction) {
+    uint8_t value = **pointer;
+    *pointer += direction;
+    return value;
+}
+
+/**
+ * Encode a single event.
+ *
+ * @param pointer[in,out] The buffer position, moved past the event.
+ * @param direction[in]   Either +1 or -1, which way to iterate the buffer.
+ * @param record[in]      The event to encode.
+ * @param delta[in]       Milliseconds since the previous event.
+ */
+static void dynamic_macro_encode(uint8_t **pointer, int8_t direction, keyrecord_t *record, uint16_t delta) {
+    uint32_t value = ((uint32_t)delta << 2) | (record->event.pressed ? DYNAMIC_MACRO_FLAG_PRESSED : 0);
+#ifndef NO_ACTION_TAPPING
+    uint8_t tap = record->tap.count | (record->tap.interrupted ? 0x10 : 0);
+    if (tap) {
+        value |= DYNAMIC_MACRO_FLAG_TAP;
+    }
+#endif
+
+    dynamic_macro_put(pointer, direction, record->event.key.row);
+    dynamic_macro_put(pointer, direction, record->event.key.col);
+    while (value > 0x7F) {
+        dynamic_macro_put(pointer, direction, (value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    dynamic_macro_put(pointer, direction, value);
+#ifndef NO_ACTION_TAPPING
+    if (tap) {
+        dynamic_macro_put(pointer, direction, tap);
+    }
+#endif
+}
+
+/**
+ * Decode a single event.
+ *
+ * @param pointer[in,out] The buffer position, moved past the event.
+ * @param direction[in]   Either +1 or -1, which way to iterate the buffer.
+ * @param record[out]     The decoded event, without a timestamp.
+ * @return                Milliseconds since the previous event.
+ */
+static uint16_t dynamic_macro_decode(uint8_t **pointer, int8_t direction, keyrecord_t *record) {
+    *record = (keyrecord_t){};
+
+    record->event.key.row = dynamic_macro_get(pointer, direction);
+    record->event.key.col = dynamic_macro_get(pointer, direction);
+
+    uint32_t value = 0;
+    uint8_t  shift = 0;
+    uint8_t  byte;
+    do {
+        byte = dynamic_macro_get(pointer, direction);
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    record->event.pressed = value & DYNAMIC_MACRO_FLAG_PRESSED;
+    if (value & DYNAMIC_MACRO_FLAG_TAP) {
+        uint8_t tap = dynamic_macro_get(pointer, direction);
+#ifndef NO_ACTION_TAPPING
+        record->tap.count       = tap & 0x0F;
+        record->tap.interrupted = tap & 0x10;
+#else
+        (void)tap;
+#endif
+    }
+    return value >> 2;
+}
+
+/* Both macros use the same buffer but read/write on different
+ * ends of it.
+ *
+ * Macro1 is written left-to-right starting from the beginning of
+ * the buffer.
+ *
+ * Macro2 is written right-to-left starting from the end of the
+ * buffer.
+ *
+ * &macro_buffer   macro_end
+ *  v                   v
+ * +------------------------------------------------------------+
+ * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
+ * +------------------------------------------------------------+
+ *                           ^                                 ^
+ *                         r_macro_end                  r_macro_buffer
+ *
+ * During the recording when one macro encounters the end of the
+ * other macro, the recording is stopped. Apart from this, there
+ * are no arbitrary limits for the macros' length in relation to
+ * each other: for example one can either have two medium sized
+ * macros or one long macro and one short macro. Or even one empty
+ * and one using the whole buffer.
+ */
+static uint8_t macro_buffer[DYNAMIC_MACRO_SIZE * sizeof(keyrecord_t)];
+
+/* Pointer to the first buffer element after the first macro.
+ * Initially points to the very beginning of the buffer since the
+ * macro is empty. */
+static uint8_t *macro_end = macro_buffer;
+
+/* The other end of the macro buffer. Serves as the beginning of
+ * the second macro. */
+static uint8_t *const r_macro_buffer = macro_buffer + sizeof(macro_buffer) - 1;
+
+/* Like macro_end but for the second macro. */
+static uint8_t *r_macro_end = r_macro_buffer;
+
+/* Timestamp of the last recorded event, for the delta of the next one. */
+static uint16_t macro_last_time;
+
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_MACRO_EEPROM_SIZE)
+/* The macros are saved to the end of the dynamic keymap macro area as
+ *
+ *   magic, macro1 length (2 bytes), macro2 length (2 bytes), macro1, macro2
+ *
+ * with macro2 in buffer order, so it can be copied back as is.
+ */
+#    define DYNAMIC_MACRO_EEPROM_MAGIC 0xD3
+#    define DYNAMIC_MACRO_EEPROM_HEADER_SIZE 5
+
+static void dynamic_macro_save(void) {
+    uint16_t length1 = macro_end - macro_buffer;
+    uint16_t length2 = r_macro_buffer - r_macro_end;
+    uint8_t  header[DYNAMIC_MACRO_EEPROM_HEADER_SIZE] = {0, length1 & 0xFF, length1 >> 8, length2 & 0xFF, length2 >> 8};
+
+    if (DYNAMIC_MACRO_EEPROM_HEADER_SIZE + length1 + length2 > dynamic_keymap_recorded_macro_get_buffer_size()) {
+        dprintln("dynamic macro: too long to save");
+        return;
+    }
+    // Invalidate first, so an interrupted save leaves no macros rather than corrupted ones
+    dynamic_keymap_recorded_macro_set_buffer(0, 1, header);
+    dynamic_keymap_recorded_macro_set_buffer(DYNAMIC_MACRO_EEPROM_HEADER_SIZE, length1, macro_buffer);
+    dynamic_keymap_recorded_macro_set_buffer(DYNAMIC_MACRO_EEPROM_HEADER_SIZE + length1, length2, r_macro_end + 1);
+    header[0] = DYNAMIC_MACRO_EEPROM_MAGIC;
+    dynamic_keymap_recorded_macro_set_buffer(1, DYNAMIC_MACRO_EEPROM_HEADER_SIZE - 1, header + 1);
+    dynamic_keymap_recorded_macro_set_buffer(0, 1, header);
+}
+
+static void dynamic_macro_load(void) {
+    uint8_t header[DYNAMIC_MACRO_EEPROM_HEADER_SIZE];
+    dynamic_keymap_recorded_macro_get_buffer(0, sizeof(header), header);
+
+    uint16_t length1 = header[1] | (header[2] << 8);
+    uint16_t length2 = header[3] | (header[4] << 8);
+    if (header[0] != DYNAMIC_MACRO_EEPROM_MAGIC || (uint32_t)length1 + length2 > sizeof(macro_buffer)) {
+        return;
+    }
+    dynamic_keymap_recorded_macro_get_buffer(DYNAMIC_MACRO_EEPROM_HEADER_SIZE, length1, macro_buffer);
+    dynamic_keymap_recorded_macro_get_buffer(DYNAMIC_MACRO_EEPROM_HEADER_SIZE + length1, length2, r_macro_buffer + 1 - length2);
+    macro_end   = macro_buffer + length1;
+    r_macro_end = r_macro_buffer - length2;
+    dprintf("dynamic macro: loaded, lengths: %u, %u\n", length1, length2);
+}
+#endif
+
 /**
  * Start recording of the dynamic macro.
  *
  * @param[out] macro_pointer The new macro buffer iterator.
  * @param[in]  macro_buffer  The macro buffer used to initialize macro_pointer.
  */
-void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_buffer) {
+void dynamic_macro_record_start(uint8_t **macro_pointer, uint8_t *macro_buffer) {
     dprintln("dynamic macro recording: started");
 
     dynamic_macro_record_start_user();
@@ -60,33 +246,134 @@ void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_
     *macro_pointer = macro_buffer;
 }
 
+/* State of the macro being played back. Events are replayed from
+ * deferred callbacks with the delays they were recorded with, so the
+ * keyboard keeps scanning while a macro plays.
+ */
+static struct {
+    uint8_t *      pointer;
+    uint8_t *      end;
+    int8_t         direction;
+    deferred_token token;
+    keyrecord_t    record;
+    layer_state_t  saved_layer_state;
+} macro_player;
+
+/* Keys pressed and released while a macro plays are held back and
+ * processed once it is over, as if the macro had been typed at once.
+ * The macro runs on the layer state it was recorded with and live
+ * input must not see it, or change it underneath the macro.
+ */
+RING_BUFFER_DEFINE(macro_input, keyrecord_t, DYNAMIC_MACRO_INPUT_QUEUE_SIZE);
+
+static bool dynamic_macro_playing(void) { return macro_player.direction != 0; }
+
+static void dynamic_macro_play_end(void) {
+    int8_t      direction = macro_player.direction;
+    keyrecord_t record;
+
+    clear_keyboard();
+
+    layer_state_set(macro_player.saved_layer_state);
+
+    macro_player.direction = 0;
+
+    dynamic_macro_play_user(direction);
+
+    /* Stop as soon as one of the held back keys starts another
+     * playback, the rest waits for that one. */
+    while (!dynamic_macro_playing() && macro_input_dequeue(&record)) {
+        process_record(&record);
+    }
+}
+
+/* Processes the pending event and every following event recorded at
+ * the same time, and returns the delay until the next one, or 0 once
+ * the macro is over. */
+static uint32_t dynamic_macro_play_events(uint32_t trigger_time, void *cb_arg) {
+    for (;;) {
+        macro_player.record.event.time = timer_read() | 1;
+        process_record(&macro_player.record);
+
+        if (macro_player.pointer == macro_player.end) {
+            dynamic_macro_play_end();
+            return 0;
+        }
+        uint16_t delay = dynamic_macro_decode(&macro_player.pointer, macro_player.direction, &macro_player.record);
+        if (delay) {
+            return delay;
+        }
+    }
+}
+
+/* Plays the rest of the current macro without the recorded delays. */
+static void dynamic_macro_play_finish(void) {
+    cancel_deferred_exec(macro_player.token);
+    while (dynamic_macro_play_events(0, NULL)) {
+    }
+}
+
 /**
- * Play the dynamic macro.
+ * Play the dynamic macro at once, without the recorded delays.
  *
- * @param macro_buffer[in] The beginning of the macro buffer being played.
- * @param macro_end[in]    The element after the last macro buffer element.
- * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ * @param pointer[in]   The beginning of the macro buffer being played.
+ * @param end[in]       The element after the last macro buffer element.
+ * @param direction[in] Either +1 or -1, which way to iterate the buffer.
  */
-void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
-    dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
-
+static void dynamic_macro_play_now(uint8_t *pointer, uint8_t *end, int8_t direction) {
     layer_state_t saved_layer_state = layer_state;
+    keyrecord_t   record;
 
     clear_keyboard();
     layer_clear();
 
-    while (macro_buffer != macro_end) {
-        process_record(macro_buffer);
-        macro_buffer += direction;
+    while (pointer != end) {
+        dynamic_macro_decode(&pointer, direction, &record);
+        record.event.time = timer_read() | 1;
+        process_record(&record);
     }
 
     clear_keyboard();
 
-    layer_state = saved_layer_state;
+    layer_state_set(saved_layer_state);
 
     dynamic_macro_play_user(direction);
 }
 
+/**
+ * Play the dynamic macro.
+ *
+ * @param macro_buffer[in] The beginning of the macro buffer being played.
+ * @param macro_end[in]    The element after the last macro buffer element.
+ * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ */
+void dynamic_macro_play(uint8_t *macro_buffer, uint8_t *macro_end, int8_t direction) {
+    dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
+
+    if (dynamic_macro_playing() || macro_buffer == macro_end) {
+        /* A macro played from within the macro being played back runs
+         * in place, like the single key event it was recorded as. */
+        dynamic_macro_play_now(macro_buffer, macro_end, direction);
+        return;
+    }
+
+    macro_player.token = defer_exec(1, dynamic_macro_play_events, NULL);
+    if (macro_player.token == INVALID_DEFERRED_TOKEN) {
+        dprintln("dynamic macro: no free deferred executor, playing without delays");
+        dynamic_macro_play_now(macro_buffer, macro_end, direction);
+        return;
+    }
+
+    macro_player.saved_layer_state = layer_state;
+    macro_player.pointer           = macro_buffer;
+    macro_player.end               = macro_end;
+    macro_player.direction         = direction;
+    dynamic_macro_decode(&macro_player.pointer, direction, &macro_player.record);
+
+    clear_keyboard();
+    layer_clear();
+}
+
 /**
  * Record a single key in a dynamic macro.
  *
@@ -96,7 +383,7 @@ void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_
  * @param direction[in]  Either +1 or -1, which way to iterate the buffer.
  * @param record[in]     The current keypress.
  */
-void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_pointer, keyrecord_t *macro2_end, int8_t direction, keyrecord_t *record) {
+void dynamic_macro_record_key(uint8_t *macro_buffer, uint8_t **macro_pointer, uint8_t *macro2_end, int8_t direction, keyrecord_t *record) {
     /* If we've just started recording, ignore all the key releases. */
     if (!record->event.pressed && *macro_pointer == macro_buffer) {
         dprintln("dynamic macro: ignoring a leading key-up event");
@@ -106,9 +393,10 @@ void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_poi
     /* The other end of the other macro is the last buffer element it
      * is safe to use before overwriting the other macro.
      */
-    if (*macro_pointer - direction != macro2_end) {
-        **macro_pointer = *record;
-        *macro_pointer += direction;
+    if (direction * (macro2_end - *macro_pointer) + 1 >= DYNAMIC_MACRO_EVENT_MAX_SIZE) {
+        uint16_t delta = *macro_pointer == macro_buffer ? 0 : TIMER_DIFF_16(record->event.time, macro_last_time);
+        dynamic_macro_encode(macro_pointer, direction, record, delta);
+        macro_last_time = record->event.time;
     } else {
         dynamic_macro_record_key_user(direction, record);
     }
@@ -120,20 +408,58 @@ void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_poi
  * End recording of the dynamic macro. Essentially just update the
  * pointer to the end of the macro.
  */
-void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_pointer, int8_t direction, keyrecord_t **macro_end) {
+void dynamic_macro_record_end(uint8_t *macro_buffer, uint8_t *macro_pointer, int8_t direction, uint8_t **macro_end) {
     dynamic_macro_record_end_user(direction);
 
     /* Do not save the keys being held when stopping the recording,
      * i.e. the keys used to access the layer DYN_REC_STOP is on.
+     * Events can't be walked backwards, so find the end of the last
+     * key-up event from the start.
      */
-    while (macro_pointer != macro_buffer && (macro_pointer - direction)->event.pressed) {
-        dprintln("dynamic macro: trimming a trailing key-down event");
-        macro_pointer -= direction;
+    uint8_t *   trimmed_end = macro_buffer;
+    uint8_t *   pointer     = macro_buffer;
+    keyrecord_t record;
+    while (pointer != macro_pointer) {
+        dynamic_macro_decode(&pointer, direction, &record);
+        if (!record.event.pressed) {
+            trimmed_end = pointer;
+        }
     }
+    if (trimmed_end != macro_pointer) {
+        dprintln("dynamic macro: trimming trailing key-down events");
+    }
+
+    dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, trimmed_end));
 
-    dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, macro_pointer));
+    *macro_end = trimmed_end;
 
-    *macro_end = macro_pointer;
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_MACRO_EEPROM_SIZE)
+    dynamic_macro_save();
+#endif
+}
+
+void dynamic_macro_init(void) {
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_MACRO_EEPROM_SIZE)
+    dynamic_macro_load();
+#endif
+}
+
+/* Hold back live input until the macro being played is over. If too
+ * much piles up, finish the macro right away instead.
+ *
+ * Called before any other processing of the record, so that held back
+ * events only go through velocikey, WPM, tap dance and key lock once,
+ * when they are replayed after the macro.
+ */
+bool preprocess_dynamic_macro(keyrecord_t *record) {
+    while (dynamic_macro_playing() && record != &macro_player.record) {
+        if (macro_input_enqueue(*record)) {
+            return false;
+        }
+        dprintln("dynamic macro: input queue full, finishing playback");
+        dynamic_macro_play_finish();
+    }
+    return true;
 }
 
 /* Handle the key events related to the dynamic macros. Should be
@@ -147,47 +473,9 @@ void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_poin
  *   }
  */
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
-    /* Both macros use the same buffer but read/write on different
-     * ends of it.
-     *
-     * Macro1 is written left-to-right starting from the beginning of
-     * the buffer.
-     *
-     * Macro2 is written right-to-left starting from the end of the
-     * buffer.
-     *
-     * &macro_buffer   macro_end
-     *  v                   v
-     * +------------------------------------------------------------+
-     * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
-     * +------------------------------------------------------------+
-     *                           ^                                 ^
-     *                         r_macro_end                  r_macro_buffer
-     *
-     * During the recording when one macro encounters the end of the
-     * other macro, the recording is stopped. Apart from this, there
-     * are no arbitrary limits for the macros' length in relation to
-     * each other: for example one can either have two medium sized
-     * macros or one long macro and one short macro. Or even one empty
-     * and one using the whole buffer.
-     */
-    static keyrecord_t macro_buffer[DYNAMIC_MACRO_SIZE];
-
-    /* Pointer to the first buffer element after the first macro.
-     * Initially points to the very beginning of the buffer since the
-     * macro is empty. */
-    static keyrecord_t *macro_end = macro_buffer;
-
-    /* The other end of the macro buffer. Serves as the beginning of
-     * the second macro. */
-    static keyrecord_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
-
-    /* Like macro_end but for the second macro. */
-    static keyrecord_t *r_macro_end = r_macro_buffer;
-
     /* A persistent pointer to the current macro position (iterator)
      * used during the recording. */
-    static keyrecord_t *macro_pointer = NULL;
+    static uint8_t *macro_pointer = NULL;
 
     /* 0   - no macro is being recorded right now
      * 1,2 - either macro 1 or 2 is being recorded */
@@ -198,12 +486,18 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
         if (!record->event.pressed) {
             switch (keycode) {
                 case DYN_REC_START1:
-                    dynamic_macro_record_start(&macro_pointer, macro_buffer);
-                    macro_id = 1;
-                    return false;
                 case DYN_REC_START2:
-                    dynamic_macro_record_start(&macro_pointer, r_macro_buffer);
-                    macro_id = 2;
+                    if (dynamic_macro_playing()) {
+                        dprintln("dynamic macro: ignoring macro record key while playing");
+                        return false;
+                    }
+                    if (keycode == DYN_REC_START1) {
+                        dynamic_macro_record_start(&macro_pointer, macro_buffer);
+                        macro_id = 1;
+                    } else {
+                        dynamic_macro_record_start(&macro_pointer, r_macro_buffer);
+                        macro_id = 2;
+                    }
                     return false;
                 case DYN_MACRO_PLAY1:
                     dynamic_macro_play(macro_buffer, macro_end, +1);
@@ -20,10 +20,11 @@
 
 #include "quantum.h"
 
-/* May be overridden with a custom value. Be aware that the effective
- * macro length is half of this value: each keypress is recorded twice
- * because of the down-event and up-event. This is not a bug, it's the
- * intended behavior.
+/* May be overridden with a custom value. The buffer takes as much RAM
+ * as this many keyrecord_t, but events are stored compactly (usually
+ * 3 bytes each), so it holds two to three times as many events. Be
+ * aware that each keypress is recorded twice because of the down-event
+ * and up-event. This is not a bug, it's the intended behavior.
  *
  * Usually it should be fine to set the macro size to at least 256 but
  * there have been reports of it being too much in some users' cases,
@@ -33,7 +34,15 @@
 #    define DYNAMIC_MACRO_SIZE 128
 #endif
 
+/* Number of key events typed while a macro plays that are held back
+ * until it is over. Must be a power of two. */
+#ifndef DYNAMIC_MACRO_INPUT_QUEUE_SIZE
+#    define DYNAMIC_MACRO_INPUT_QUEUE_SIZE 16
+#endif
+
 void dynamic_macro_led_blink(void);
+void dynamic_macro_init(void);
+bool preprocess_dynamic_macro(keyrecord_t *record);
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record);
 void dynamic_macro_record_start_user(void);
 void dynamic_macro_play_user(int8_t direction);
@@ -75,87 +75,154 @@ void restorePinState(pin_t pin, uint16_t restoreState) {
 
 __attribute__((weak)) bool process_joystick_analogread() { return process_joystick_analogread_quantum(); }
 
-bool process_joystick_analogread_quantum() {
 #if JOYSTICK_AXES_COUNT > 0
-    for (int axis_index = 0; axis_index < JOYSTICK_AXES_COUNT; ++axis_index) {
-        if (joystick_axes[axis_index].input_pin == JS_VIRTUAL_AXIS) {
-            continue;
-        }
+// ADC readings after oversampling and filtering, in 1/16 steps
+static int32_t axis_filtered[JOYSTICK_AXES_COUNT];
+static bool    axis_filter_primed = false;
 
-        // save previous input pin status as well
-        uint16_t inputSavedState = savePinState(joystick_axes[axis_index].input_pin);
+static uint32_t read_axis_pin(uint8_t axis_index) {
+    // save previous input pin status as well
+    uint16_t inputSavedState = savePinState(joystick_axes[axis_index].input_pin);
 
-        // disable pull-up resistor
-        writePinLow(joystick_axes[axis_index].input_pin);
+    // disable pull-up resistor
+    writePinLow(joystick_axes[axis_index].input_pin);
 
-        // if pin was a pull-up input, we need to uncharge it by turning it low
-        // before making it a low input
-        setPinOutput(joystick_axes[axis_index].input_pin);
+    // if pin was a pull-up input, we need to uncharge it by turning it low
+    // before making it a low input
+    setPinOutput(joystick_axes[axis_index].input_pin);
 
-        wait_us(10);
+    wait_us(10);
 
-        // save and apply output pin status
-        uint16_t outputSavedState = 0;
-        if (joystick_axes[axis_index].output_pin != JS_VIRTUAL_AXIS) {
-            // save previous output pin status
-            outputSavedState = savePinState(joystick_axes[axis_index].output_pin);
+    // save and apply output pin status
+    uint16_t outputSavedState = 0;
+    if (joystick_axes[axis_index].output_pin != JS_VIRTUAL_AXIS) {
+        // save previous output pin status
+        outputSavedState = savePinState(joystick_axes[axis_index].output_pin);
 
-            setPinOutput(joystick_axes[axis_index].output_pin);
-            writePinHigh(joystick_axes[axis_index].output_pin);
-        }
+        setPinOutput(joystick_axes[axis_index].output_pin);
+        writePinHigh(joystick_axes[axis_index].output_pin);
+    }
 
-        uint16_t groundSavedState = 0;
-        if (joystick_axes[axis_index].ground_pin != JS_VIRTUAL_AXIS) {
-            // save previous output pin status
-            groundSavedState = savePinState(joystick_axes[axis_index].ground_pin);
+    uint16_t groundSavedState = 0;
+    if (joystick_axes[axis_index].ground_pin != JS_VIRTUAL_AXIS) {
+        // save previous output pin status
+        groundSavedState = savePinState(joystick_axes[axis_index].ground_pin);
 
-            setPinOutput(joystick_axes[axis_index].ground_pin);
-            writePinLow(joystick_axes[axis_index].ground_pin);
-        }
+        setPinOutput(joystick_axes[axis_index].ground_pin);
+        writePinLow(joystick_axes[axis_index].ground_pin);
+    }
 
-        wait_us(10);
+    wait_us(10);
 
-        setPinInput(joystick_axes[axis_index].input_pin);
+    setPinInput(joystick_axes[axis_index].input_pin);
 
-        wait_us(10);
+    wait_us(10);
 
+    uint32_t sum = 0;
+    for (uint8_t n = 0; n < JOYSTICK_OVERSAMPLE; n++) {
 #    if defined(__AVR__) || defined(PROTOCOL_CHIBIOS)
-        int16_t axis_val = analogReadPin(joystick_axes[axis_index].input_pin);
+        sum += analogReadPin(joystick_axes[axis_index].input_pin);
 #    else
         // default to resting position
-        int16_t axis_val = joystick_axes[axis_index].mid_digit;
+        sum += joystick_axes[axis_index].mid_digit;
 #    endif
+    }
 
-        // test the converted value against the lower range
-        int32_t ref        = joystick_axes[axis_index].mid_digit;
-        int32_t range      = joystick_axes[axis_index].min_digit;
-        int32_t ranged_val = ((axis_val - ref) * -JOYSTICK_RESOLUTION) / (range - ref);
+    // restore output, ground and input status
+    if (joystick_axes[axis_index].output_pin != JS_VIRTUAL_AXIS) {
+        restorePinState(joystick_axes[axis_index].output_pin, outputSavedState);
+    }
+    if (joystick_axes[axis_index].ground_pin != JS_VIRTUAL_AXIS) {
+        restorePinState(joystick_axes[axis_index].ground_pin, groundSavedState);
+    }
 
-        if (ranged_val > 0) {
-            // the value is in the higher range
-            range      = joystick_axes[axis_index].max_digit;
-            ranged_val = ((axis_val - ref) * JOYSTICK_RESOLUTION) / (range - ref);
-        }
+    restorePinState(joystick_axes[axis_index].input_pin, inputSavedState);
 
-        // clamp the result in the valid range
-        ranged_val = ranged_val < -JOYSTICK_RESOLUTION ? -JOYSTICK_RESOLUTION : ranged_val;
-        ranged_val = ranged_val > JOYSTICK_RESOLUTION ? JOYSTICK_RESOLUTION : ranged_val;
+    return sum;
+}
 
-        if (ranged_val != joystick_status.axes[axis_index]) {
-            joystick_status.axes[axis_index] = ranged_val;
-            joystick_status.status |= JS_UPDATED;
+#    if defined(JOYSTICK_ADC_GROUP) && defined(PROTOCOL_CHIBIOS)
+/* Reads every directly connected axis in one scan group conversion. Returns false, leaving the axes to be read one at a
+ * time, when any axis switches an output or ground pin or the ADC cannot convert them together.
+ */
+static bool read_axes_group(uint32_t *sums) {
+    adc_mux muxes[JOYSTICK_AXES_COUNT];
+    uint8_t count = 0;
+    for (uint8_t axis_index = 0; axis_index < JOYSTICK_AXES_COUNT; ++axis_index) {
+        if (joystick_axes[axis_index].input_pin == JS_VIRTUAL_AXIS) {
+            continue;
         }
-
-        // restore output, ground and input status
-        if (joystick_axes[axis_index].output_pin != JS_VIRTUAL_AXIS) {
-            restorePinState(joystick_axes[axis_index].output_pin, outputSavedState);
+        if (joystick_axes[axis_index].output_pin != JS_VIRTUAL_AXIS || joystick_axes[axis_index].ground_pin != JS_VIRTUAL_AXIS) {
+            return false;
         }
-        if (joystick_axes[axis_index].ground_pin != JS_VIRTUAL_AXIS) {
-            restorePinState(joystick_axes[axis_index].ground_pin, groundSavedState);
+        palSetLineMode(joystick_axes[axis_index].input_pin, PAL_MODE_INPUT_ANALOG);
+        muxes[count++] = pinToMux(joystick_axes[axis_index].input_pin);
+    }
+    if (count == 0 || !adc_read_group(muxes, count, JOYSTICK_OVERSAMPLE, sums)) {
+        return false;
+    }
+    // spread the results back out to their axes, virtual ones keep a slot that is never used
+    for (int8_t axis_index = JOYSTICK_AXES_COUNT - 1; axis_index >= 0; --axis_index) {
+        if (joystick_axes[axis_index].input_pin != JS_VIRTUAL_AXIS) {
+            sums[axis_index] = sums[--count];
         }
+    }
+    return true;
+}
+#    endif
+
+static void update_axis(uint8_t axis_index, uint32_t sum) {
+    int32_t sample = (int32_t)((sum << 4) / JOYSTICK_OVERSAMPLE);
+    if (!axis_filter_primed) {
+        axis_filtered[axis_index] = sample;
+    } else {
+        // exponential moving average, each new sample weighs 1 / 2^JOYSTICK_FILTER
+        axis_filtered[axis_index] += (sample - axis_filtered[axis_index]) >> JOYSTICK_FILTER;
+    }
+
+    // test the converted value against the lower range
+    int32_t axis_val   = axis_filtered[axis_index];
+    int32_t ref        = (int32_t)joystick_axes[axis_index].mid_digit << 4;
+    int32_t range      = (int32_t)joystick_axes[axis_index].min_digit << 4;
+    int32_t ranged_val = ((axis_val - ref) * -JOYSTICK_RESOLUTION) / (range - ref);
+
+    if (ranged_val > 0) {
+        // the value is in the higher range
+        range      = (int32_t)joystick_axes[axis_index].max_digit << 4;
+        ranged_val = ((axis_val - ref) * JOYSTICK_RESOLUTION) / (range - ref);
+    }
+
+    // clamp the result in the valid range
+    ranged_val = ranged_val < -JOYSTICK_RESOLUTION ? -JOYSTICK_RESOLUTION : ranged_val;
+    ranged_val = ranged_val > JOYSTICK_RESOLUTION ? JOYSTICK_RESOLUTION : ranged_val;
+
+    int32_t delta = ranged_val - joystick_status.axes[axis_index];
+    if (delta == 0) {
+        return;
+    }
+    // small changes are noise, but rest and the ends of the range are always reported exactly
+    if (delta > JOYSTICK_DEADBAND || delta < -JOYSTICK_DEADBAND || ranged_val == 0 || ranged_val == JOYSTICK_RESOLUTION || ranged_val == -JOYSTICK_RESOLUTION) {
+        joystick_status.axes[axis_index] = ranged_val;
+        joystick_status.status |= JS_UPDATED;
+    }
+}
+#endif
 
-        restorePinState(joystick_axes[axis_index].input_pin, inputSavedState);
+bool process_joystick_analogread_quantum() {
+#if JOYSTICK_AXES_COUNT > 0
+    uint32_t sums[JOYSTICK_AXES_COUNT];
+    bool     grouped = false;
+#    if defined(JOYSTICK_ADC_GROUP) && defined(PROTOCOL_CHIBIOS)
+    grouped = read_axes_group(sums);
+#    endif
+
+    for (int axis_index = 0; axis_index < JOYSTICK_AXES_COUNT; ++axis_index) {
+        if (joystick_axes[axis_index].input_pin == JS_VIRTUAL_AXIS) {
+            continue;
+        }
+        update_axis(axis_index, grouped ? sums[axis_index] : read_axis_pin(axis_index));
     }
+    axis_filter_primed = true;
 
 #endif
     return true;
@@ -31,8 +31,94 @@ __attribute__((weak)) void leader_end(void) {}
 bool     leading     = false;
 uint16_t leader_time = 0;
 
-uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
-uint8_t  leader_sequence_size = 0;
+uint16_t leader_sequence[LEADER_SEQUENCE_LENGTH] = {0};
+uint8_t  leader_sequence_size                    = 0;
+
+#    ifdef LEADER_SEQUENCE_TABLE
+/* leader_sequences[] is sorted, so the sequences sharing the keys typed so far always form a contiguous run of it,
+ * which makes the table a flattened trie: every key narrows the run [leader_match_lo, leader_match_hi) with two
+ * binary searches on the next column, and a sequence is complete at depth d when its key at d is 0. Because shorter
+ * sequences sort before their extensions, the complete sequence (if any) is always the first entry of the run.
+ */
+static uint16_t       leader_match_lo      = 0;
+static uint16_t       leader_match_hi      = 0;
+static deferred_token leader_timeout_token = INVALID_DEFERRED_TOKEN;
+
+static inline uint16_t leader_sequence_key(uint16_t index, uint8_t depth) { return pgm_read_word(&leader_sequences[index].keys[depth]); }
+
+static bool leader_sequence_complete(uint16_t index, uint8_t depth) { return depth >= LEADER_SEQUENCE_LENGTH || leader_sequence_key(index, depth) == 0; }
+
+// First entry in [lo, hi) whose key at depth is not below keycode, or when upper is set, above it
+static uint16_t leader_search(uint16_t lo, uint16_t hi, uint8_t depth, uint16_t keycode, bool upper) {
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        uint16_t key = leader_sequence_key(mid, depth);
+        if (key < keycode || (upper && key == keycode)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Ends the sequence, running the action of the sequence typed so far if there is one
+static void leader_sequence_finish(void) {
+    cancel_deferred_exec(leader_timeout_token);
+    leader_timeout_token = INVALID_DEFERRED_TOKEN;
+    leading              = false;
+    if (leader_match_lo < leader_match_hi && leader_sequence_complete(leader_match_lo, leader_sequence_size)) {
+        void (*action)(void) = (void (*)(void))pgm_read_ptr(&leader_sequences[leader_match_lo].action);
+        if (action) {
+            action();
+        }
+    }
+    leader_end();
+}
+
+static uint32_t leader_timeout(uint32_t trigger_time, void *cb_arg) {
+    leader_timeout_token = INVALID_DEFERRED_TOKEN;
+    leader_sequence_finish();
+    return 0;
+}
+
+static void leader_sequence_step(uint16_t keycode) {
+    uint8_t depth   = leader_sequence_size - 1;
+    leader_match_lo = leader_search(leader_match_lo, leader_match_hi, depth, keycode, false);
+    leader_match_hi = leader_search(leader_match_lo, leader_match_hi, depth, keycode, true);
+
+    if (leader_match_lo == leader_match_hi) {
+        // Nothing starts with these keys, so there is no point waiting for the timeout
+        leader_sequence_finish();
+    } else if (leader_match_hi - leader_match_lo == 1 && leader_sequence_complete(leader_match_lo, leader_sequence_size)) {
+        // Exactly one sequence left and it has no longer extensions, fire it straight away
+        leader_sequence_finish();
+    }
+}
+
+#        ifndef NO_DEBUG
+static void leader_sequence_check_order(void) {
+    static bool checked = false;
+    if (checked) {
+        return;
+    }
+    checked = true;
+    for (uint16_t i = 1; i < leader_sequences_count; i++) {
+        for (uint8_t depth = 0; depth < LEADER_SEQUENCE_LENGTH; depth++) {
+            uint16_t prev = leader_sequence_key(i - 1, depth);
+            uint16_t key  = leader_sequence_key(i, depth);
+            if (prev < key) {
+                break;
+            }
+            if (prev > key || depth == LEADER_SEQUENCE_LENGTH - 1) {
+                dprintf("leader: leader_sequences[%u] is out of order or duplicated\n", i);
+                return;
+            }
+        }
+    }
+}
+#        endif
+#    endif
 
 void qk_leader_start(void) {
     if (leading) {
@@ -43,6 +129,14 @@ void qk_leader_start(void) {
     leader_time          = timer_read();
     leader_sequence_size = 0;
     memset(leader_sequence, 0, sizeof(leader_sequence));
+#    ifdef LEADER_SEQUENCE_TABLE
+#        ifndef NO_DEBUG
+    leader_sequence_check_order();
+#        endif
+    leader_match_lo      = 0;
+    leader_match_hi      = leader_sequences_count;
+    leader_timeout_token = defer_exec(LEADER_TIMEOUT, leader_timeout, NULL);
+#    endif
 }
 
 bool process_leader(uint16_t keycode, keyrecord_t *record) {
@@ -55,7 +149,7 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
                     keycode = keycode & 0xFF;
                 }
 #    endif  // LEADER_KEY_STRICT_KEY_PROCESSING
-                if (leader_sequence_size < (sizeof(leader_sequence) / sizeof(leader_sequence[0]))) {
+                if (leader_sequence_size < LEADER_SEQUENCE_LENGTH) {
                     leader_sequence[leader_sequence_size] = keycode;
                     leader_sequence_size++;
                 } else {
@@ -64,6 +158,14 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
                 }
 #    ifdef LEADER_PER_KEY_TIMING
                 leader_time = timer_read();
+#        ifdef LEADER_SEQUENCE_TABLE
+                extend_deferred_exec(leader_timeout_token, LEADER_TIMEOUT);
+#        endif
+#    endif
+#    ifdef LEADER_SEQUENCE_TABLE
+                if (leading) {
+                    leader_sequence_step(keycode);
+                }
 #    endif
                 return false;
             }
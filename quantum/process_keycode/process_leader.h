@@ -18,6 +18,26 @@
 
 #include "quantum.h"
 
+#define LEADER_SEQUENCE_LENGTH 5
+
+/* Entry of the keymap's leader_sequences[] table, enabled with LEADER_SEQUENCE_TABLE
+ *
+ * keys holds the sequence typed after KC_LEAD, padded with 0. The table must be sorted by keys, comparing the first
+ * key, then the second and so on, with missing keys counting as 0 (so "A" comes before "A B", which comes before "B").
+ */
+typedef struct {
+    uint16_t keys[LEADER_SEQUENCE_LENGTH];
+    void (*action)(void);
+} leader_sequence_t;
+
+#define LEADER_SEQ(func, ...) \
+    { .keys = {__VA_ARGS__}, .action = func }
+
+#ifdef LEADER_SEQUENCE_TABLE
+extern const leader_sequence_t leader_sequences[];
+extern const uint16_t          leader_sequences_count;
+#endif
+
 bool process_leader(uint16_t keycode, keyrecord_t *record);
 
 void leader_start(void);
@@ -30,9 +50,9 @@ void qk_leader_start(void);
 #define SEQ_FOUR_KEYS(key1, key2, key3, key4) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == 0)
 #define SEQ_FIVE_KEYS(key1, key2, key3, key4, key5) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == (key5))
 
-#define LEADER_EXTERNS()                \
-    extern bool     leading;            \
-    extern uint16_t leader_time;        \
-    extern uint16_t leader_sequence[5]; \
+#define LEADER_EXTERNS()                                     \
+    extern bool     leading;                                 \
+    extern uint16_t leader_time;                             \
+    extern uint16_t leader_sequence[LEADER_SEQUENCE_LENGTH]; \
     extern uint8_t  leader_sequence_size
 #define LEADER_DICTIONARY() if (leading && timer_elapsed(leader_time) > LEADER_TIMEOUT)
@@ -28,10 +28,10 @@
 #    ifndef CG_SWAP_SONG
 #        define CG_SWAP_SONG SONG(AG_SWAP_SOUND)
 #    endif
-float ag_norm_song[][2] = AG_NORM_SONG;
-float ag_swap_song[][2] = AG_SWAP_SONG;
-float cg_norm_song[][2] = CG_NORM_SONG;
-float cg_swap_song[][2] = CG_SWAP_SONG;
+SONG_NOTES(ag_norm_song[]) = AG_NORM_SONG;
+SONG_NOTES(ag_swap_song[]) = AG_SWAP_SONG;
+SONG_NOTES(cg_norm_song[]) = CG_NORM_SONG;
+SONG_NOTES(cg_swap_song[]) = CG_SWAP_SONG;
 #endif
 
 /**
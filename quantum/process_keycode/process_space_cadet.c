@@ -16,6 +16,10 @@
 #include "process_space_cadet.h"
 #include "action_tapping.h"
 
+#ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+#    include "adaptive_tapping.h"
+#endif
+
 // ********** OBSOLETE DEFINES, STOP USING! (pls?) **********
 // Shift / paren setup
 #ifndef LSPO_KEY
@@ -94,9 +98,19 @@ void perform_space_cadet(keyrecord_t *record, uint16_t sc_keycode, uint8_t holdM
         }
     } else {
 #ifdef TAPPING_TERM_PER_KEY
-        if (sc_last == holdMod && timer_elapsed(sc_timer) < get_tapping_term(sc_keycode, record))
+        uint16_t tapping_term = get_tapping_term(sc_keycode, record);
+#else
+        uint16_t tapping_term = TAPPING_TERM;
+#endif
+        uint16_t elapsed      = timer_elapsed(sc_timer);
+#ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+        uint16_t learned_term = adaptive_tapping_term(sc_keycode, tapping_term);
+        if (sc_last == holdMod && elapsed < tapping_term) {
+            adaptive_tapping_record_tap(sc_keycode, elapsed);
+        }
+        if (sc_last == holdMod && elapsed < learned_term)
 #else
-        if (sc_last == holdMod && timer_elapsed(sc_timer) < TAPPING_TERM)
+        if (sc_last == holdMod && elapsed < tapping_term)
 #endif
         {
             if (holdMod != tapMod) {
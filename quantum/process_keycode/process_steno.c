@@ -18,6 +18,9 @@
 #include "eeprom.h"
 #include "keymap_steno.h"
 #include "virtser.h"
+#ifdef STENO_REPEAT
+#    include "deferred_exec.h"
+#endif
 #include <string.h>
 
 // TxBolt Codes
@@ -58,26 +61,40 @@
 #define GEMINI_STATE_SIZE 6
 #define MAX_STATE_SIZE GEMINI_STATE_SIZE
 
+#define STENO_KEY_COUNT (STN__MAX - STN__MIN + 1)
+
+// Where a key lives in the packed state: the byte, and the bits to set in it
+typedef struct {
+    uint8_t index;
+    uint8_t mask;
+} steno_bit_t;
+
 static uint8_t      state[MAX_STATE_SIZE] = {0};
 static uint8_t      chord[MAX_STATE_SIZE] = {0};
 static int8_t       pressed               = 0;
+static bool         chord_sent            = false;  // already sent by first-up or repeat, do not send it again on release
 static steno_mode_t mode;
+#ifdef STENO_REPEAT
+static deferred_token repeat_token = INVALID_DEFERRED_TOKEN;
+#endif
 
-static const uint8_t boltmap[64] PROGMEM = {TXB_NUL, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_S_L, TXB_S_L, TXB_T_L, TXB_K_L, TXB_P_L, TXB_W_L, TXB_H_L, TXB_R_L, TXB_A_L, TXB_O_L, TXB_STR, TXB_STR, TXB_NUL, TXB_NUL, TXB_NUL, TXB_STR, TXB_STR, TXB_E_R, TXB_U_R, TXB_F_R, TXB_R_R, TXB_P_R, TXB_B_R, TXB_L_R, TXB_G_R, TXB_T_R, TXB_S_R, TXB_D_R, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_Z_R};
+// TX Bolt bytes carry their group in the top two bits, so the group is the byte index as well
+#define BOLT(code) \
+    { TXB_GET_GROUP(code), code }
+static const steno_bit_t boltmap[STENO_KEY_COUNT] PROGMEM = {BOLT(TXB_NUL), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_S_L), BOLT(TXB_S_L), BOLT(TXB_T_L), BOLT(TXB_K_L), BOLT(TXB_P_L), BOLT(TXB_W_L), BOLT(TXB_H_L), BOLT(TXB_R_L), BOLT(TXB_A_L), BOLT(TXB_O_L), BOLT(TXB_STR), BOLT(TXB_STR), BOLT(TXB_NUL), BOLT(TXB_NUL), BOLT(TXB_NUL), BOLT(TXB_STR), BOLT(TXB_STR), BOLT(TXB_E_R), BOLT(TXB_U_R), BOLT(TXB_F_R), BOLT(TXB_R_R), BOLT(TXB_P_R), BOLT(TXB_B_R), BOLT(TXB_L_R), BOLT(TXB_G_R), BOLT(TXB_T_R), BOLT(TXB_S_R), BOLT(TXB_D_R), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_NUM), BOLT(TXB_Z_R)};
+
+// GeminiPR packs 7 keys into each byte, most significant first, leaving the top bit to mark the start of a packet
+#define GEMINI(key) \
+    { (key) / 7, 1 << (6 - (key) % 7) }
+#define GEMINI_BYTE(n) GEMINI(n * 7), GEMINI(n * 7 + 1), GEMINI(n * 7 + 2), GEMINI(n * 7 + 3), GEMINI(n * 7 + 4), GEMINI(n * 7 + 5), GEMINI(n * 7 + 6)
+static const steno_bit_t geminimap[STENO_KEY_COUNT] PROGMEM = {GEMINI_BYTE(0), GEMINI_BYTE(1), GEMINI_BYTE(2), GEMINI_BYTE(3), GEMINI_BYTE(4), GEMINI_BYTE(5)};
+
+_Static_assert(STENO_KEY_COUNT <= 7 * GEMINI_STATE_SIZE, "GeminiPR supports no more than 42 steno keys");
 
 static void steno_clear_state(void) {
     memset(state, 0, sizeof(state));
     memset(chord, 0, sizeof(chord));
-}
-
-static void send_steno_state(uint8_t size, bool send_empty) {
-    for (uint8_t i = 0; i < size; ++i) {
-        if (chord[i] || send_empty) {
-#ifdef VIRTSER_ENABLE
-            virtser_send(chord[i]);
-#endif
-        }
-    }
+    chord_sent = false;
 }
 
 void steno_init() {
@@ -88,6 +105,10 @@ void steno_init() {
 }
 
 void steno_set_mode(steno_mode_t new_mode) {
+#ifdef STENO_REPEAT
+    cancel_deferred_exec(repeat_token);
+    repeat_token = INVALID_DEFERRED_TOKEN;
+#endif
     steno_clear_state();
     mode = new_mode;
     eeprom_update_byte(EECONFIG_STENOMODE, mode);
@@ -104,48 +125,64 @@ __attribute__((weak)) bool process_steno_user(uint16_t keycode, keyrecord_t *rec
 
 static void send_steno_chord(void) {
     if (send_steno_chord_user(mode, chord)) {
-        switch (mode) {
-            case STENO_MODE_BOLT:
-                send_steno_state(BOLT_STATE_SIZE, false);
 #ifdef VIRTSER_ENABLE
-                virtser_send(0);  // terminating byte
-#endif
+        switch (mode) {
+            case STENO_MODE_BOLT: {
+                // Only groups with keys in them are sent, then a terminating byte, all in one transfer
+                uint8_t frame[BOLT_STATE_SIZE + 1];
+                uint8_t length = 0;
+                for (uint8_t i = 0; i < BOLT_STATE_SIZE; ++i) {
+                    if (chord[i]) {
+                        frame[length++] = chord[i];
+                    }
+                }
+                frame[length++] = 0;
+                virtser_send_buffer(frame, length);
                 break;
+            }
             case STENO_MODE_GEMINI:
                 chord[0] |= 0x80;  // Indicate start of packet
-                send_steno_state(GEMINI_STATE_SIZE, true);
+                virtser_send_buffer(chord, GEMINI_STATE_SIZE);
                 break;
         }
+#endif
     }
-    steno_clear_state();
+    chord_sent = true;
 }
 
 uint8_t *steno_get_state(void) { return &state[0]; }
 
 uint8_t *steno_get_chord(void) { return &chord[0]; }
 
-static bool update_state_bolt(uint8_t key, bool press) {
-    uint8_t boltcode = pgm_read_byte(boltmap + key);
+static void update_state(uint8_t key, bool press) {
+    const steno_bit_t *map   = mode == STENO_MODE_GEMINI ? geminimap : boltmap;
+    uint8_t            index = pgm_read_byte(&map[key].index);
+    uint8_t            mask  = pgm_read_byte(&map[key].mask);
     if (press) {
-        state[TXB_GET_GROUP(boltcode)] |= boltcode;
-        chord[TXB_GET_GROUP(boltcode)] |= boltcode;
+        if (chord_sent) {
+            // A new chord starts with the keys still held from the one that was sent
+            memcpy(chord, state, sizeof(chord));
+            chord_sent = false;
+        }
+        state[index] |= mask;
+        chord[index] |= mask;
+    } else if (mode == STENO_MODE_BOLT) {
+        // The group bits are shared by every key in the byte, so they only go with the last key of the group
+        state[index] &= ~(mask & ~TXB_GRPMASK);
+        if (!(state[index] & ~TXB_GRPMASK)) {
+            state[index] = 0;
+        }
     } else {
-        state[TXB_GET_GROUP(boltcode)] &= ~boltcode;
+        state[index] &= ~mask;
     }
-    return false;
 }
 
-static bool update_state_gemini(uint8_t key, bool press) {
-    int     idx = key / 7;
-    uint8_t bit = 1 << (6 - (key % 7));
-    if (press) {
-        state[idx] |= bit;
-        chord[idx] |= bit;
-    } else {
-        state[idx] &= ~bit;
-    }
-    return false;
+#ifdef STENO_REPEAT
+static uint32_t repeat_steno_chord(uint32_t trigger_time, void *cb_arg) {
+    send_steno_chord();
+    return STENO_REPEAT_INTERVAL;
 }
+#endif
 
 bool process_steno(uint16_t keycode, keyrecord_t *record) {
     switch (keycode) {
@@ -171,23 +208,31 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
             if (!process_steno_user(keycode, record)) {
                 return false;
             }
-            switch (mode) {
-                case STENO_MODE_BOLT:
-                    update_state_bolt(keycode - QK_STENO, IS_PRESSED(record->event));
-                    break;
-                case STENO_MODE_GEMINI:
-                    update_state_gemini(keycode - QK_STENO, IS_PRESSED(record->event));
-                    break;
-            }
+            update_state(keycode - QK_STENO, IS_PRESSED(record->event));
+#ifdef STENO_REPEAT
+            // Only a chord that stays unchanged for STENO_REPEAT_DELAY repeats
+            cancel_deferred_exec(repeat_token);
+            repeat_token = INVALID_DEFERRED_TOKEN;
+#endif
             // allow postprocessing hooks
             if (postprocess_steno_user(keycode, record, mode, chord, pressed)) {
                 if (IS_PRESSED(record->event)) {
                     ++pressed;
+#ifdef STENO_REPEAT
+                    repeat_token = defer_exec(STENO_REPEAT_DELAY, repeat_steno_chord, NULL);
+#endif
                 } else {
                     --pressed;
                     if (pressed <= 0) {
                         pressed = 0;
+                        if (!chord_sent) {
+                            send_steno_chord();
+                        }
+                        steno_clear_state();
+#ifdef STENO_FIRST_UP
+                    } else if (!chord_sent) {
                         send_steno_chord();
+#endif
                     }
                 }
             }
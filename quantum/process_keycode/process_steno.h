@@ -18,6 +18,14 @@
 
 #include "quantum.h"
 
+// How long a chord has to be held before it starts repeating, and how often it repeats after that, in milliseconds
+#ifndef STENO_REPEAT_DELAY
+#    define STENO_REPEAT_DELAY 500
+#endif
+#ifndef STENO_REPEAT_INTERVAL
+#    define STENO_REPEAT_INTERVAL 100
+#endif
+
 typedef enum { STENO_MODE_BOLT, STENO_MODE_GEMINI } steno_mode_t;
 
 bool     process_steno(uint16_t keycode, keyrecord_t *record);
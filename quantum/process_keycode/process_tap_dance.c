@@ -13,14 +13,32 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <string.h>
 #include "quantum.h"
 
 #ifndef NO_ACTION_ONESHOT
 uint8_t get_oneshot_mods(void);
 #endif
 
+#ifndef TAP_DANCE_MAX_ACTIVE
+#    define TAP_DANCE_MAX_ACTIVE 8
+#endif
+
 static uint16_t last_td;
-static int8_t   highest_td = -1;
+
+// Indices of the dances with a non-zero count, oldest first, so interruptions only visit dances that are in progress
+static uint8_t active_td[TAP_DANCE_MAX_ACTIVE];
+static uint8_t active_td_count = 0;
+
+static void deactivate_tap_dance(uint8_t idx) {
+    for (uint8_t i = 0; i < active_td_count; i++) {
+        if (active_td[i] == idx) {
+            active_td_count--;
+            memmove(&active_td[i], &active_td[i + 1], active_td_count - i);
+            return;
+        }
+    }
+}
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data) {
     qk_tap_dance_pair_t *pair = (qk_tap_dance_pair_t *)user_data;
@@ -78,6 +96,32 @@ void qk_tap_dance_dual_role_reset(qk_tap_dance_state_t *state, void *user_data)
     }
 }
 
+void qk_tap_dance_tap_hold_finished(qk_tap_dance_state_t *state, void *user_data) {
+    qk_tap_dance_tap_hold_t *tap_hold = (qk_tap_dance_tap_hold_t *)user_data;
+
+    if (state->count == 1 && state->pressed && !state->interrupted && tap_hold->hold) {
+        tap_hold->held = tap_hold->hold;
+    } else if (state->count == 2 && tap_hold->double_tap) {
+        tap_hold->held = tap_hold->double_tap;
+    } else {
+        // Without a matching entry every tap counts, and only the last one stays registered while the key is down
+        for (uint8_t i = 1; i < state->count; i++) {
+            tap_code16(tap_hold->tap);
+        }
+        tap_hold->held = tap_hold->tap;
+    }
+    register_code16(tap_hold->held);
+}
+
+void qk_tap_dance_tap_hold_reset(qk_tap_dance_state_t *state, void *user_data) {
+    qk_tap_dance_tap_hold_t *tap_hold = (qk_tap_dance_tap_hold_t *)user_data;
+
+    if (tap_hold->held) {
+        unregister_code16(tap_hold->held);
+        tap_hold->held = KC_NO;
+    }
+}
+
 static inline void _process_tap_dance_action_fn(qk_tap_dance_state_t *state, void *user_data, qk_tap_dance_user_fn_t fn) {
     if (fn) {
         fn(state, user_data);
@@ -95,6 +139,28 @@ static inline void process_tap_dance_action_on_dance_finished(qk_tap_dance_actio
     _process_tap_dance_action_fn(&action->state, action->user_data, action->fn.on_dance_finished);
 }
 
+static uint16_t tap_dance_term(qk_tap_dance_action_t *action, keyrecord_t *record) {
+    if (action->custom_tapping_term > 0) {
+        return action->custom_tapping_term;
+    }
+#ifdef TAPPING_TERM_PER_KEY
+    return get_tapping_term(action->state.keycode, record);
+#else
+    return TAPPING_TERM;
+#endif
+}
+
+static uint32_t tap_dance_timeout(uint32_t trigger_time, void *cb_arg) {
+    qk_tap_dance_action_t *action = (qk_tap_dance_action_t *)cb_arg;
+
+    action->state.timeout_token = INVALID_DEFERRED_TOKEN;
+    if (action->state.count) {
+        process_tap_dance_action_on_dance_finished(action);
+        reset_tap_dance(&action->state);
+    }
+    return 0;
+}
+
 static inline void process_tap_dance_action_on_reset(qk_tap_dance_action_t *action) {
     _process_tap_dance_action_fn(&action->state, action->user_data, action->fn.on_reset);
     del_mods(action->state.oneshot_mods);
@@ -102,15 +168,37 @@ static inline void process_tap_dance_action_on_reset(qk_tap_dance_action_t *acti
     send_keyboard_report();
 }
 
+static void activate_tap_dance(uint8_t idx) {
+    for (uint8_t i = 0; i < active_td_count; i++) {
+        if (active_td[i] == idx) {
+            return;
+        }
+    }
+    if (active_td_count == TAP_DANCE_MAX_ACTIVE) {
+        // Finish the oldest dance to make room, one that is still held is reset when its key is released
+        uint8_t                oldest = active_td[0];
+        qk_tap_dance_action_t *action = &tap_dance_actions[oldest];
+        process_tap_dance_action_on_dance_finished(action);
+        reset_tap_dance(&action->state);
+        deactivate_tap_dance(oldest);
+    }
+    active_td[active_td_count++] = idx;
+}
+
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
     qk_tap_dance_action_t *action;
 
     if (!record->event.pressed) return;
 
-    if (highest_td == -1) return;
+    if (active_td_count == 0) return;
+
+    // Resetting a dance removes it from the active set, so walk a snapshot of it
+    uint8_t active[TAP_DANCE_MAX_ACTIVE];
+    uint8_t count = active_td_count;
+    memcpy(active, active_td, count);
 
-    for (int i = 0; i <= highest_td; i++) {
-        action = &tap_dance_actions[i];
+    for (uint8_t i = 0; i < count; i++) {
+        action = &tap_dance_actions[active[i]];
         if (action->state.count) {
             if (keycode == action->state.keycode && keycode == last_td) continue;
             action->state.interrupted          = true;
@@ -127,14 +215,20 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
     switch (keycode) {
         case QK_TAP_DANCE ... QK_TAP_DANCE_MAX:
-            if ((int16_t)idx > highest_td) highest_td = idx;
             action = &tap_dance_actions[idx];
 
             action->state.pressed = record->event.pressed;
             if (record->event.pressed) {
                 action->state.keycode = keycode;
                 action->state.count++;
+                activate_tap_dance(idx);
                 action->state.timer = timer_read();
+
+                // The dance finishes once the tapping term has passed without another tap
+                uint16_t tapping_term = tap_dance_term(action, record);
+                if (!extend_deferred_exec(action->state.timeout_token, tapping_term + 1)) {
+                    action->state.timeout_token = defer_exec(tapping_term + 1, tap_dance_timeout, action);
+                }
 #ifndef NO_ACTION_ONESHOT
                 action->state.oneshot_mods = get_oneshot_mods();
 #else
@@ -157,28 +251,6 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
-void matrix_scan_tap_dance() {
-    if (highest_td == -1) return;
-    uint16_t tap_user_defined;
-
-    for (uint8_t i = 0; i <= highest_td; i++) {
-        qk_tap_dance_action_t *action = &tap_dance_actions[i];
-        if (action->custom_tapping_term > 0) {
-            tap_user_defined = action->custom_tapping_term;
-        } else {
-#ifdef TAPPING_TERM_PER_KEY
-            tap_user_defined = get_tapping_term(action->state.keycode, NULL);
-#else
-            tap_user_defined = TAPPING_TERM;
-#endif
-        }
-        if (action->state.count && timer_elapsed(action->state.timer) > tap_user_defined) {
-            process_tap_dance_action_on_dance_finished(action);
-            reset_tap_dance(&action->state);
-        }
-    }
-}
-
 void reset_tap_dance(qk_tap_dance_state_t *state) {
     qk_tap_dance_action_t *action;
 
@@ -186,6 +258,9 @@ void reset_tap_dance(qk_tap_dance_state_t *state) {
 
     action = &tap_dance_actions[state->keycode - QK_TAP_DANCE];
 
+    cancel_deferred_exec(state->timeout_token);
+    state->timeout_token = INVALID_DEFERRED_TOKEN;
+
     process_tap_dance_action_on_reset(action);
 
     state->count                = 0;
@@ -193,4 +268,5 @@ void reset_tap_dance(qk_tap_dance_state_t *state) {
     state->finished             = false;
     state->interrupting_keycode = 0;
     last_td                     = 0;
+    deactivate_tap_dance(state->keycode - QK_TAP_DANCE);
 }
@@ -20,6 +20,7 @@
 
 #    include <stdbool.h>
 #    include <inttypes.h>
+#    include "deferred_exec.h"
 
 typedef struct {
     uint8_t  count;
@@ -27,10 +28,11 @@ typedef struct {
     uint8_t  weak_mods;
     uint16_t keycode;
     uint16_t interrupting_keycode;
-    uint16_t timer;
-    bool     interrupted;
-    bool     pressed;
-    bool     finished;
+    uint16_t       timer;
+    deferred_token timeout_token;
+    bool           interrupted;
+    bool           pressed;
+    bool           finished;
 } qk_tap_dance_state_t;
 
 #    define TD(n) (QK_TAP_DANCE | ((n)&0xFF))
@@ -59,6 +61,13 @@ typedef struct {
     void (*layer_function)(uint8_t);
 } qk_tap_dance_dual_role_t;
 
+typedef struct {
+    uint16_t tap;
+    uint16_t hold;
+    uint16_t double_tap;
+    uint16_t held;
+} qk_tap_dance_tap_hold_t;
+
 #    define ACTION_TAP_DANCE_DOUBLE(kc1, kc2) \
         { .fn = {qk_tap_dance_pair_on_each_tap, qk_tap_dance_pair_finished, qk_tap_dance_pair_reset}, .user_data = (void *)&((qk_tap_dance_pair_t){kc1, kc2}), }
 
@@ -70,6 +79,12 @@ typedef struct {
 
 #    define ACTION_TAP_DANCE_LAYER_MOVE(kc, layer) ACTION_TAP_DANCE_DUAL_ROLE(kc, layer)
 
+#    define ACTION_TAP_DANCE_TAP_HOLD(tap, hold) \
+        { .fn = {NULL, qk_tap_dance_tap_hold_finished, qk_tap_dance_tap_hold_reset}, .user_data = (void *)&((qk_tap_dance_tap_hold_t){tap, hold, KC_NO, KC_NO}), }
+
+#    define ACTION_TAP_DANCE_TAP_HOLD_DOUBLE(tap, hold, double_tap) \
+        { .fn = {NULL, qk_tap_dance_tap_hold_finished, qk_tap_dance_tap_hold_reset}, .user_data = (void *)&((qk_tap_dance_tap_hold_t){tap, hold, double_tap, KC_NO}), }
+
 #    define ACTION_TAP_DANCE_FN(user_fn) \
         { .fn = {NULL, user_fn, NULL}, .user_data = NULL, }
 
@@ -85,7 +100,6 @@ extern qk_tap_dance_action_t tap_dance_actions[];
 
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record);
 bool process_tap_dance(uint16_t keycode, keyrecord_t *record);
-void matrix_scan_tap_dance(void);
 void reset_tap_dance(qk_tap_dance_state_t *state);
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data);
@@ -96,6 +110,9 @@ void qk_tap_dance_dual_role_on_each_tap(qk_tap_dance_state_t *state, void *user_
 void qk_tap_dance_dual_role_finished(qk_tap_dance_state_t *state, void *user_data);
 void qk_tap_dance_dual_role_reset(qk_tap_dance_state_t *state, void *user_data);
 
+void qk_tap_dance_tap_hold_finished(qk_tap_dance_state_t *state, void *user_data);
+void qk_tap_dance_tap_hold_reset(qk_tap_dance_state_t *state, void *user_data);
+
 #else
 
 #    define TD(n) KC_NO
@@ -40,7 +40,7 @@ __attribute__((weak)) const char terminal_prompt[8] = "> ";
 #    ifndef TERMINAL_SONG
 #        define TERMINAL_SONG SONG(TERMINAL_SOUND)
 #    endif
-float terminal_song[][2] = TERMINAL_SONG;
+SONG_NOTES(terminal_song[]) = TERMINAL_SONG;
 #    define TERMINAL_BELL() PLAY_SONG(terminal_song)
 #else
 #    define TERMINAL_BELL()
@@ -60,12 +60,7 @@ __attribute__((weak)) void qk_ucis_symbol_fallback(void) {
 
 __attribute__((weak)) void qk_ucis_cancel(void) {}
 
-void register_ucis(const uint32_t *code_points) {
-    for (int i = 0; i < UCIS_MAX_CODE_POINTS && code_points[i]; i++) {
-        register_unicode(code_points[i]);
-        wait_ms(UNICODE_TYPE_DELAY);
-    }
-}
+void register_ucis(const uint32_t *code_points) { register_unicode_sequence(code_points, UCIS_MAX_CODE_POINTS); }
 
 bool process_ucis(uint16_t keycode, keyrecord_t *record) {
     if (!qk_ucis_state.in_progress || !record->event.pressed) {
@@ -155,38 +155,71 @@ __attribute__((weak)) void unicode_input_cancel(void) {
     set_mods(unicode_saved_mods);  // Reregister previously set mods
 }
 
-void register_hex(uint16_t hex) {
-    for (int i = 3; i >= 0; i--) {
-        uint8_t digit = ((hex >> (i * 4)) & 0xF);
-        send_nibble(digit);
-    }
+// Whether the hex digit for ascii is typed with a single unmodified key
+static bool unicode_digit_is_plain(uint8_t ascii) {
+    uint8_t bit = 1 << (ascii % 8);
+    return !((pgm_read_byte(&ascii_to_shift_lut[ascii / 8]) | pgm_read_byte(&ascii_to_altgr_lut[ascii / 8]) | pgm_read_byte(&ascii_to_dead_lut[ascii / 8])) & bit);
 }
 
-void register_hex32(uint32_t hex) {
-    bool onzerostart = true;
-    for (int i = 7; i >= 0; i--) {
-        if (i <= 3) {
-            onzerostart = false;
-        }
-        uint8_t digit = ((hex >> (i * 4)) & 0xF);
-        if (digit == 0) {
-            if (!onzerostart) {
-                send_nibble(digit);
+/* Types the lowest count hex digits of hex, most significant first
+ *
+ * In the input modes of UNICODE_ROLLOVER_MODES each digit is pressed in the
+ * same report that releases the previous one, so a digit costs one report
+ * instead of two. The host still sees the presses in order.
+ */
+static void unicode_send_digits(uint32_t hex, uint8_t count) {
+    bool    rollover = (UNICODE_ROLLOVER_MODES >> unicode_config.input_mode) & 1;
+    uint8_t held     = KC_NO;
+
+    while (count--) {
+        uint8_t digit   = (hex >> (count * 4)) & 0xF;
+        uint8_t ascii   = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[ascii]);
+
+        if (!rollover || !unicode_digit_is_plain(ascii)) {
+            if (held) {
+                unregister_code(held);
+                held = KC_NO;
             }
-        } else {
             send_nibble(digit);
-            onzerostart = false;
+            continue;
         }
+
+        if (held) {
+            del_key(held);
+            if (held == keycode) {
+                // The same key has to be seen released before it can be pressed again
+                send_keyboard_report();
+            }
+        }
+        add_key(keycode);
+        send_keyboard_report();
+        held = keycode;
+#if TAP_CODE_DELAY > 0
+        wait_ms(TAP_CODE_DELAY);
+#endif
+    }
+
+    if (held) {
+        unregister_code(held);
     }
 }
 
-void register_unicode(uint32_t code_point) {
-    if (code_point > 0x10FFFF || (code_point > 0xFFFF && unicode_config.input_mode == UC_WIN)) {
-        // Code point out of range, do nothing
-        return;
+void register_hex(uint16_t hex) { unicode_send_digits(hex, 4); }
+
+void register_hex32(uint32_t hex) {
+    // Leading zeros are skipped, but at least four digits are typed
+    uint8_t count = 8;
+    while (count > 4 && !(hex >> ((count - 1) * 4))) {
+        count--;
     }
+    unicode_send_digits(hex, count);
+}
 
-    unicode_input_start();
+static bool unicode_code_point_is_valid(uint32_t code_point) { return code_point <= 0x10FFFF && !(code_point > 0xFFFF && unicode_config.input_mode == UC_WIN); }
+
+// Types the digits of code_point within an already started input sequence
+static void unicode_send_code_point(uint32_t code_point) {
     if (code_point > 0xFFFF && unicode_config.input_mode == UC_MAC) {
         // Convert code point to UTF-16 surrogate pair on macOS
         code_point -= 0x10000;
@@ -196,9 +229,52 @@ void register_unicode(uint32_t code_point) {
     } else {
         register_hex32(code_point);
     }
+}
+
+/* Sends code_point as part of a run of code points
+ *
+ * macOS takes any number of four digit code units while the input key is held,
+ * so consecutive code points share one input sequence there. Other input modes
+ * finish and start a sequence for every code point, with UNICODE_TYPE_DELAY in
+ * between so the host has finished the previous one.
+ */
+static void unicode_send_in_sequence(uint32_t code_point, bool *in_progress) {
+    if (*in_progress && unicode_config.input_mode != UC_MAC) {
+        unicode_input_finish();
+        wait_ms(UNICODE_TYPE_DELAY);
+        *in_progress = false;
+    }
+    if (!*in_progress) {
+        unicode_input_start();
+        *in_progress = true;
+    }
+    unicode_send_code_point(code_point);
+}
+
+void register_unicode(uint32_t code_point) {
+    if (!unicode_code_point_is_valid(code_point)) {
+        // Code point out of range, do nothing
+        return;
+    }
+
+    unicode_input_start();
+    unicode_send_code_point(code_point);
     unicode_input_finish();
 }
 
+void register_unicode_sequence(const uint32_t *code_points, uint8_t count) {
+    bool in_progress = false;
+
+    for (uint8_t i = 0; i < count && code_points[i]; i++) {
+        if (unicode_code_point_is_valid(code_points[i])) {
+            unicode_send_in_sequence(code_points[i], &in_progress);
+        }
+    }
+    if (in_progress) {
+        unicode_input_finish();
+    }
+}
+
 // clang-format off
 
 void send_unicode_hex_string(const char *str) {
@@ -264,14 +340,18 @@ void send_unicode_string(const char *str) {
         return;
     }
 
+    bool in_progress = false;
     while (*str) {
         int32_t code_point = 0;
         str                = decode_utf8(str, &code_point);
 
-        if (code_point >= 0) {
-            register_unicode(code_point);
+        if (code_point >= 0 && unicode_code_point_is_valid(code_point)) {
+            unicode_send_in_sequence(code_point, &in_progress);
         }
     }
+    if (in_progress) {
+        unicode_input_finish();
+    }
 }
 
 // clang-format off
@@ -280,31 +360,31 @@ static void audio_helper(void) {
 #ifdef AUDIO_ENABLE
     switch (get_unicode_input_mode()) {
 #    ifdef UNICODE_SONG_MAC
-        static float song_mac[][2] = UNICODE_SONG_MAC;
+        static SONG_NOTES(song_mac[]) = UNICODE_SONG_MAC;
         case UC_MAC:
             PLAY_SONG(song_mac);
             break;
 #    endif
 #    ifdef UNICODE_SONG_LNX
-        static float song_lnx[][2] = UNICODE_SONG_LNX;
+        static SONG_NOTES(song_lnx[]) = UNICODE_SONG_LNX;
         case UC_LNX:
             PLAY_SONG(song_lnx);
             break;
 #    endif
 #    ifdef UNICODE_SONG_WIN
-        static float song_win[][2] = UNICODE_SONG_WIN;
+        static SONG_NOTES(song_win[]) = UNICODE_SONG_WIN;
         case UC_WIN:
             PLAY_SONG(song_win);
             break;
 #    endif
 #    ifdef UNICODE_SONG_BSD
-        static float song_bsd[][2] = UNICODE_SONG_BSD;
+        static SONG_NOTES(song_bsd[]) = UNICODE_SONG_BSD;
         case UC_BSD:
             PLAY_SONG(song_bsd);
             break;
 #    endif
 #    ifdef UNICODE_SONG_WINC
-        static float song_winc[][2] = UNICODE_SONG_WINC;
+        static SONG_NOTES(song_winc[]) = UNICODE_SONG_WINC;
         case UC_WINC:
             PLAY_SONG(song_winc);
             break;
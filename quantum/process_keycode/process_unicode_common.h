@@ -49,6 +49,12 @@
 #    define UNICODE_TYPE_DELAY 10
 #endif
 
+// Input modes (as a bitmask of 1 << UC_xxx) that accept the hex digits rolled
+// over, i.e. each digit pressed in the same report that releases the previous
+#ifndef UNICODE_ROLLOVER_MODES
+#    define UNICODE_ROLLOVER_MODES ((1 << UC_MAC) | (1 << UC_LNX) | (1 << UC_WINC))
+#endif
+
 // Deprecated aliases
 #if !defined(UNICODE_KEY_MAC) && defined(UNICODE_KEY_OSX)
 #    define UNICODE_KEY_MAC UNICODE_KEY_OSX
@@ -89,6 +95,7 @@ void unicode_input_cancel(void);
 void register_hex(uint16_t hex);
 void register_hex32(uint32_t hex);
 void register_unicode(uint32_t code_point);
+void register_unicode_sequence(const uint32_t *code_points, uint8_t count);
 
 void send_unicode_hex_string(const char *str);
 void send_unicode_string(const char *str);
@@ -44,12 +44,12 @@
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
 #    endif
-float goodbye_song[][2] = GOODBYE_SONG;
+SONG_NOTES(goodbye_song[]) = GOODBYE_SONG;
 #    ifdef DEFAULT_LAYER_SONGS
-float default_layer_songs[][16][2] = DEFAULT_LAYER_SONGS;
+SONG_NOTES(default_layer_songs[][16]) = DEFAULT_LAYER_SONGS;
 #    endif
 #    ifdef SENDSTRING_BELL
-float bell_song[][2] = SONG(TERMINAL_SOUND);
+SONG_NOTES(bell_song[]) = SONG(TERMINAL_SOUND);
 #    endif
 #endif
 
@@ -178,107 +178,164 @@ void post_process_record_quantum(keyrecord_t *record) {
 /* Core keycode function, hands off handling to other functions,
     then processes internal quantum keycodes, and then processes
     ACTIONs.                                                      */
-bool process_record_quantum(keyrecord_t *record) {
-    uint16_t keycode = get_record_keycode(record, true);
+#if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
+static bool process_rgb_record(uint16_t keycode, keyrecord_t *record) { return process_rgb(keycode, record); }
+#endif
 
-    // This is how you use actions here
-    // if (keycode == KC_LEAD) {
-    //   action_t action;
-    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
-    //   process_action(record, action);
-    //   return false;
-    // }
+typedef bool (*process_record_handler_t)(uint16_t keycode, keyrecord_t *record);
 
-#ifdef VELOCIKEY_ENABLE
-    if (velocikey_enabled() && record->event.pressed) {
-        velocikey_accelerate();
-    }
-#endif
+typedef struct {
+    process_record_handler_t handler;
+    uint16_t                 first_keycode;
+    uint16_t                 last_keycode;
+    uint8_t                  events;
+} process_record_entry_t;
 
-#ifdef WPM_ENABLE
-    if (record->event.pressed) {
-        update_wpm(keycode);
-    }
-#endif
+#define PROCESS_ON_PRESS 0x01
+#define PROCESS_ON_RELEASE 0x02
+#define PROCESS_ON_ANY (PROCESS_ON_PRESS | PROCESS_ON_RELEASE)
 
-#ifdef TAP_DANCE_ENABLE
-    preprocess_tap_dance(keycode, record);
-#endif
+// Keycode ranges handlers declare, handlers that react to every key (recorders, feedback, modal features) use ALL
+#define PROCESS_ALL_KEYCODES 0x0000, 0xFFFF
+#define PROCESS_QUANTUM_KEYCODES RESET, (SAFE_RANGE - 1)
 
-    if (!(
-#if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
-#endif
+/* Core keycode handlers, in the order they get to see (and swallow) a record.
+ *
+ * Each entry is only called for keycodes within [first_keycode, last_keycode] and the event kinds it lists, so a
+ * plain KC_A skips every handler that only implements its own quantum keycodes instead of calling into each of them.
+ */
+static const process_record_entry_t process_record_table[] PROGMEM = {
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+    // Must run asap to ensure all keypresses are recorded.
+    {process_dynamic_macro, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+    {process_clicky, PROCESS_ALL_KEYCODES, PROCESS_ON_PRESS},
 #endif  // AUDIO_CLICKY
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+    {process_haptic, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif  // HAPTIC_ENABLE
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+    {process_record_via, FN_MO13, MACRO15, PROCESS_ON_ANY},
 #endif
-            process_record_kb(keycode, record) &&
+    {process_record_kb, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+    {process_sequencer, PROCESS_QUANTUM_KEYCODES, PROCESS_ON_PRESS},
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+    {process_midi, PROCESS_QUANTUM_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+    {process_audio, PROCESS_QUANTUM_KEYCODES, PROCESS_ON_PRESS},
 #endif
 #ifdef BACKLIGHT_ENABLE
-            process_backlight(keycode, record) &&
+    {process_backlight, PROCESS_QUANTUM_KEYCODES, PROCESS_ON_PRESS},
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+    {process_steno, QK_STENO, QK_STENO_MAX, PROCESS_ON_ANY},
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+    {process_music, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+    {process_tap_dance, QK_TAP_DANCE, QK_TAP_DANCE_MAX, PROCESS_ON_ANY},
 #endif
 #if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
-            process_unicode_common(keycode, record) &&
+    {process_unicode_common, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+    {process_leader, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef COMBO_ENABLE
-            process_combo(keycode, record) &&
+    {process_combo, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef PRINTING_ENABLE
-            process_printer(keycode, record) &&
+    {process_printer, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+    {process_auto_shift, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef TERMINAL_ENABLE
-            process_terminal(keycode, record) &&
+    {process_terminal, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+    {process_space_cadet, PROCESS_ALL_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+    {process_magic, PROCESS_QUANTUM_KEYCODES, PROCESS_ON_PRESS},
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+    {process_grave_esc, GRAVE_ESC, GRAVE_ESC, PROCESS_ON_ANY},
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+    {process_rgb_record, PROCESS_QUANTUM_KEYCODES, PROCESS_ON_ANY},
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+    {process_joystick, JS_BUTTON_MIN, JS_BUTTON_MAX, PROCESS_ON_ANY},
 #endif
-            true)) {
+};
+
+/** \brief Runs the core keycode handlers in order
+ *
+ * Returns false as soon as one of them swallows the record.
+ */
+static bool process_record_handlers(uint16_t keycode, keyrecord_t *record) {
+    const uint8_t event = record->event.pressed ? PROCESS_ON_PRESS : PROCESS_ON_RELEASE;
+
+    for (uint8_t i = 0; i < sizeof(process_record_table) / sizeof(process_record_table[0]); i++) {
+        const process_record_entry_t *entry = &process_record_table[i];
+        if (keycode < pgm_read_word(&entry->first_keycode) || keycode > pgm_read_word(&entry->last_keycode) || !(pgm_read_byte(&entry->events) & event)) {
+            continue;
+        }
+        process_record_handler_t handler = (process_record_handler_t)pgm_read_ptr(&entry->handler);
+        if (!handler(keycode, record)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool process_record_quantum(keyrecord_t *record) {
+#ifdef DYNAMIC_MACRO_ENABLE
+    if (!preprocess_dynamic_macro(record)) {
+        return false;
+    }
+#endif
+
+    uint16_t keycode = get_record_keycode(record, true);
+
+    // This is how you use actions here
+    // if (keycode == KC_LEAD) {
+    //   action_t action;
+    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
+    //   process_action(record, action);
+    //   return false;
+    // }
+
+#ifdef VELOCIKEY_ENABLE
+    if (velocikey_enabled() && record->event.pressed) {
+        velocikey_accelerate();
+    }
+#endif
+
+#ifdef WPM_ENABLE
+    if (record->event.pressed) {
+        update_wpm(keycode);
+    }
+#endif
+
+#ifdef TAP_DANCE_ENABLE
+    preprocess_tap_dance(keycode, record);
+#endif
+
+#if defined(KEY_LOCK_ENABLE)
+    // Must run first to be able to mask key_up events.
+    if (!process_key_lock(&keycode, record)) {
+        return false;
+    }
+#endif
+
+    if (!process_record_handlers(keycode, record)) {
         return false;
     }
 
@@ -340,6 +397,20 @@ layer_state_t update_tri_layer_state(layer_state_t state, uint8_t layer1, uint8_
 
 void update_tri_layer(uint8_t layer1, uint8_t layer2, uint8_t layer3) { layer_state_set(update_tri_layer_state(layer_state, layer1, layer2, layer3)); }
 
+#ifdef AUDIO_ENABLE
+// There are some tasks that need to be run a little bit
+// after keyboard startup, or else they will not work correctly
+// because of interaction with the USB device state, which
+// may still be in flux...
+//
+// At the moment the only feature that needs this is the
+// startup song.
+static uint32_t delayed_audio_startup(uint32_t trigger_time, void *cb_arg) {
+    audio_startup();
+    return 0;
+}
+#endif
+
 void matrix_init_quantum() {
 #ifdef BOOTMAGIC_LITE
     bootmagic_lite();
@@ -360,6 +431,7 @@ void matrix_init_quantum() {
 #endif
 #ifdef AUDIO_ENABLE
     audio_init();
+    defer_exec(300, delayed_audio_startup, NULL);
 #endif
 #ifdef RGB_MATRIX_ENABLE
     rgb_matrix_init();
@@ -370,6 +442,9 @@ void matrix_init_quantum() {
 #ifdef HAPTIC_ENABLE
     haptic_init();
 #endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_init();
+#endif
 #if defined(BLUETOOTH_ENABLE) && defined(OUTPUT_AUTO_ENABLE)
     set_output(OUTPUT_AUTO);
 #endif
@@ -378,25 +453,7 @@ void matrix_init_quantum() {
 }
 
 void matrix_scan_quantum() {
-#if defined(AUDIO_ENABLE)
-    // There are some tasks that need to be run a little bit
-    // after keyboard startup, or else they will not work correctly
-    // because of interaction with the USB device state, which
-    // may still be in flux...
-    //
-    // At the moment the only feature that needs this is the
-    // startup song.
-    static bool     delayed_tasks_run  = false;
-    static uint16_t delayed_task_timer = 0;
-    if (!delayed_tasks_run) {
-        if (!delayed_task_timer) {
-            delayed_task_timer = timer_read();
-        } else if (timer_elapsed(delayed_task_timer) > 300) {
-            audio_startup();
-            delayed_tasks_run = true;
-        }
-    }
-#endif
+    deferred_exec_task();
 
 #if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
     matrix_scan_music();
@@ -406,22 +463,10 @@ void matrix_scan_quantum() {
     matrix_scan_sequencer();
 #endif
 
-#ifdef TAP_DANCE_ENABLE
-    matrix_scan_tap_dance();
-#endif
-
-#ifdef COMBO_ENABLE
-    matrix_scan_combo();
-#endif
-
 #ifdef LED_MATRIX_ENABLE
     led_matrix_task();
 #endif
 
-#ifdef WPM_ENABLE
-    decay_wpm();
-#endif
-
 #ifdef HAPTIC_ENABLE
     haptic_task();
 #endif
@@ -430,10 +475,6 @@ void matrix_scan_quantum() {
     dip_switch_read(false);
 #endif
 
-#ifdef AUTO_SHIFT_ENABLE
-    autoshift_matrix_scan();
-#endif
-
     matrix_scan_kb();
 }
 
@@ -63,6 +63,7 @@
 #include "print.h"
 #include "send_string.h"
 #include "suspend.h"
+#include "deferred_exec.h"
 #include <stddef.h>
 #include <stdlib.h>
 
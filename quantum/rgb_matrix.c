@@ -43,7 +43,7 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv
 
 // ------------------------------------------
 // -----Begin rgb effect includes macros-----
-#define RGB_MATRIX_EFFECT(name)
+#define RGB_MATRIX_EFFECT(name, ...)
 #define RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
 #include "rgb_matrix_animations/rgb_matrix_effects.inc"
@@ -124,24 +124,9 @@ uint32_t     g_rgb_timer;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #endif  // RGB_MATRIX_FRAMEBUFFER_EFFECTS
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-last_hit_t g_last_hit_tracker;
-#endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
 // internals
-static uint8_t         rgb_last_enable   = UINT8_MAX;
-static uint8_t         rgb_last_effect   = UINT8_MAX;
-static effect_params_t rgb_effect_params = {0, 0xFF};
-static rgb_task_states rgb_task_state    = SYNCING;
-#if RGB_DISABLE_TIMEOUT > 0
-static uint32_t rgb_anykey_timer;
-#endif  // RGB_DISABLE_TIMEOUT > 0
-
-// double buffers
-static uint32_t rgb_timer_buffer;
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-static last_hit_t last_hit_buffer;
-#endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
+static lighting_task_t rgb_task = {.state = SYNCING, .params = {0, LED_FLAG_ALL, false}, .last_effect = UINT8_MAX, .last_enable = UINT8_MAX};
 
 void eeconfig_read_rgb_matrix(void) { eeprom_read_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
 
@@ -188,14 +173,10 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
 #ifndef RGB_MATRIX_SPLIT
     if (!is_keyboard_master()) return;
 #endif
-#if RGB_DISABLE_TIMEOUT > 0
-    rgb_anykey_timer = 0;
-#endif  // RGB_DISABLE_TIMEOUT > 0
-
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     uint8_t led[LED_HITS_TO_REMEMBER];
     uint8_t led_count = 0;
 
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 #    if defined(RGB_MATRIX_KEYRELEASES)
     if (!pressed)
 #    elif defined(RGB_MATRIX_KEYPRESSES)
@@ -204,25 +185,10 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
     {
         led_count = rgb_matrix_map_row_column_to_led(row, col, led);
     }
-
-    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2);  // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count--;
-    }
-
-    for (uint8_t i = 0; i < led_count; i++) {
-        uint8_t index                = last_hit_buffer.count;
-        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
-        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
-        last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
-        last_hit_buffer.count++;
-    }
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+    lighting_task_record_hits(&rgb_task, led, led_count);
+
 #if defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && !defined(DISABLE_RGB_MATRIX_TYPING_HEATMAP)
     if (rgb_matrix_config.mode == RGB_MATRIX_TYPING_HEATMAP) {
         process_rgb_matrix_typing_heatmap(row, col);
@@ -263,80 +229,21 @@ static bool rgb_matrix_none(effect_params_t *params) {
     return false;
 }
 
-static void rgb_task_timers(void) {
-#if defined(RGB_MATRIX_KEYREACTIVE_ENABLED) || RGB_DISABLE_TIMEOUT > 0
-    uint32_t deltaTime = sync_timer_elapsed32(rgb_timer_buffer);
-#endif  // defined(RGB_MATRIX_KEYREACTIVE_ENABLED) || RGB_DISABLE_TIMEOUT > 0
-    rgb_timer_buffer = sync_timer_read32();
-
-    // Update double buffer timers
-#if RGB_DISABLE_TIMEOUT > 0
-    if (rgb_anykey_timer < UINT32_MAX) {
-        if (UINT32_MAX - deltaTime < rgb_anykey_timer) {
-            rgb_anykey_timer = UINT32_MAX;
-        } else {
-            rgb_anykey_timer += deltaTime;
-        }
-    }
-#endif  // RGB_DISABLE_TIMEOUT > 0
-
-    // Update double buffer last hit timers
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
-            continue;
-        }
-        last_hit_buffer.tick[i] += deltaTime;
-    }
-#endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
-}
-
-static void rgb_task_sync(void) {
-    // next task
-    if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
-}
-
-static void rgb_task_start(void) {
-    // reset iter
-    rgb_effect_params.iter = 0;
-
-    // update double buffers
-    g_rgb_timer = rgb_timer_buffer;
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker = last_hit_buffer;
-#endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
-
-    // next task
-    rgb_task_state = RENDERING;
-}
-
-static void rgb_task_render(uint8_t effect) {
-    bool rendering         = false;
-    rgb_effect_params.init = (effect != rgb_last_effect) || (rgb_matrix_config.enable != rgb_last_enable);
-
-    // each effect can opt to do calculations
-    // and/or request PWM buffer updates.
-    switch (effect) {
-        case RGB_MATRIX_NONE:
-            rendering = rgb_matrix_none(&rgb_effect_params);
-            break;
+// Effect table, indexed by enum rgb_matrix_effects. The effect ID is simply the
+// position in this table, so dispatch is one PROGMEM pointer load instead of a
+// case chain, and the optional second argument of RGB_MATRIX_EFFECT() becomes
+// the entry's metadata.
+static const rgb_matrix_effect_t rgb_matrix_effect_table[RGB_MATRIX_EFFECT_MAX] PROGMEM = {
+    [RGB_MATRIX_NONE] = {rgb_matrix_none, RGB_MATRIX_EFFECT_FLAG_NONE},
 
 // ---------------------------------------------
-// -----Begin rgb effect switch case macros-----
-#define RGB_MATRIX_EFFECT(name, ...)          \
-    case RGB_MATRIX_##name:                   \
-        rendering = name(&rgb_effect_params); \
-        break;
+// -----Begin rgb effect table macros-----------
+#define RGB_MATRIX_EFFECT(name, ...) [RGB_MATRIX_##name] = {name, (__VA_ARGS__ + 0)},
 #include "rgb_matrix_animations/rgb_matrix_effects.inc"
 #undef RGB_MATRIX_EFFECT
 
 #if defined(RGB_MATRIX_CUSTOM_KB) || defined(RGB_MATRIX_CUSTOM_USER)
-#    define RGB_MATRIX_EFFECT(name, ...)          \
-        case RGB_MATRIX_CUSTOM_##name:            \
-            rendering = name(&rgb_effect_params); \
-            break;
+#    define RGB_MATRIX_EFFECT(name, ...) [RGB_MATRIX_CUSTOM_##name] = {name, (__VA_ARGS__ + 0)},
 #    ifdef RGB_MATRIX_CUSTOM_KB
 #        include "rgb_matrix_kb.inc"
 #    endif
@@ -345,43 +252,47 @@ static void rgb_task_render(uint8_t effect) {
 #    endif
 #    undef RGB_MATRIX_EFFECT
 #endif
-            // -----End rgb effect switch case macros-------
-            // ---------------------------------------------
+    // -----End rgb effect table macros-------------
+    // ---------------------------------------------
+};
 
-        // Factory default magic value
-        case UINT8_MAX: {
-            rgb_matrix_test();
-            rgb_task_state = FLUSHING;
-        }
-            return;
+uint8_t rgb_matrix_get_effect_flags(uint8_t mode) {
+    if (mode >= RGB_MATRIX_EFFECT_MAX) {
+        return RGB_MATRIX_EFFECT_FLAG_NONE;
     }
+    return pgm_read_byte(&rgb_matrix_effect_table[mode].flags);
+}
 
-    rgb_effect_params.iter++;
+static void rgb_task_render(uint8_t effect) {
+    bool rendering = false;
+    lighting_task_render_begin(&rgb_task, effect, rgb_matrix_config.enable);
 
-    // next task
-    if (!rendering) {
-        rgb_task_state = FLUSHING;
-        if (!rgb_effect_params.init && effect == RGB_MATRIX_NONE) {
-            // We only need to flush once if we are RGB_MATRIX_NONE
-            rgb_task_state = SYNCING;
-        }
+    // Factory default magic value
+    if (effect == UINT8_MAX) {
+        rgb_matrix_test();
+        rgb_task.state = FLUSHING;
+        return;
+    }
+
+    // each effect can opt to do calculations
+    // and/or request PWM buffer updates.
+    if (effect < RGB_MATRIX_EFFECT_MAX) {
+        rgb_matrix_effect_func_t effect_func = (rgb_matrix_effect_func_t)pgm_read_ptr(&rgb_matrix_effect_table[effect].func);
+        rendering                            = effect_func(&rgb_task.params);
     }
+
+    lighting_task_render_end(&rgb_task, effect, rendering);
 }
 
 static void rgb_task_flush(uint8_t effect) {
-    // update last trackers after the first full render so we can init over several frames
-    rgb_last_effect = effect;
-    rgb_last_enable = rgb_matrix_config.enable;
+    lighting_task_flush(&rgb_task, effect, rgb_matrix_config.enable);
 
     // update pwm buffers
     rgb_matrix_update_pwm_buffers();
-
-    // next task
-    rgb_task_state = SYNCING;
 }
 
 void rgb_matrix_task(void) {
-    rgb_task_timers();
+    lighting_task_timers(&rgb_task);
 
     // Ideally we would also stop sending zeros to the LED driver PWM buffers
     // while suspended and just do a software shutdown. This is a cheap hack for now.
@@ -390,28 +301,28 @@ void rgb_matrix_task(void) {
         g_suspend_state ||
 #endif  // RGB_DISABLE_WHEN_USB_SUSPENDED == true
 #if RGB_DISABLE_TIMEOUT > 0
-        (rgb_anykey_timer > (uint32_t)RGB_DISABLE_TIMEOUT) ||
+        (rgb_task.anykey_timer > (uint32_t)RGB_DISABLE_TIMEOUT) ||
 #endif  // RGB_DISABLE_TIMEOUT > 0
         false;
 
     uint8_t effect = suspend_backlight || !rgb_matrix_config.enable ? 0 : rgb_matrix_config.mode;
 
-    switch (rgb_task_state) {
+    switch (rgb_task.state) {
         case STARTING:
-            rgb_task_start();
+            lighting_task_start(&rgb_task, &g_rgb_timer);
             break;
         case RENDERING:
             rgb_task_render(effect);
             if (effect) {
                 rgb_matrix_indicators();
-                rgb_matrix_indicators_advanced(&rgb_effect_params);
+                rgb_matrix_indicators_advanced(&rgb_task.params);
             }
             break;
         case FLUSHING:
             rgb_task_flush(effect);
             break;
         case SYNCING:
-            rgb_task_sync();
+            lighting_task_sync(&rgb_task, g_rgb_timer, RGB_MATRIX_LED_FLUSH_LIMIT);
             break;
     }
 }
@@ -450,17 +361,7 @@ __attribute__((weak)) void rgb_matrix_indicators_advanced_user(uint8_t led_min,
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        g_last_hit_tracker.tick[i] = UINT16_MAX;
-    }
-
-    last_hit_buffer.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        last_hit_buffer.tick[i] = UINT16_MAX;
-    }
-#endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
+    lighting_task_init(&rgb_task);
 
     if (!eeconfig_is_enabled()) {
         dprintf("rgb_matrix_init_drivers eeconfig is not enabled.\n");
@@ -487,7 +388,7 @@ bool rgb_matrix_get_suspend_state(void) { return g_suspend_state; }
 
 void rgb_matrix_toggle_eeprom_helper(bool write_to_eeprom) {
     rgb_matrix_config.enable ^= 1;
-    rgb_task_state = STARTING;
+    rgb_task.state = STARTING;
     if (write_to_eeprom) {
         eeconfig_update_rgb_matrix();
     }
@@ -502,7 +403,7 @@ void rgb_matrix_enable(void) {
 }
 
 void rgb_matrix_enable_noeeprom(void) {
-    if (!rgb_matrix_config.enable) rgb_task_state = STARTING;
+    if (!rgb_matrix_config.enable) rgb_task.state = STARTING;
     rgb_matrix_config.enable = 1;
 }
 
@@ -512,7 +413,7 @@ void rgb_matrix_disable(void) {
 }
 
 void rgb_matrix_disable_noeeprom(void) {
-    if (rgb_matrix_config.enable) rgb_task_state = STARTING;
+    if (rgb_matrix_config.enable) rgb_task.state = STARTING;
     rgb_matrix_config.enable = 0;
 }
 
@@ -529,7 +430,7 @@ void rgb_matrix_mode_eeprom_helper(uint8_t mode, bool write_to_eeprom) {
     } else {
         rgb_matrix_config.mode = mode;
     }
-    rgb_task_state = STARTING;
+    rgb_task.state = STARTING;
     if (write_to_eeprom) {
         eeconfig_update_rgb_matrix();
     }
@@ -618,6 +519,6 @@ void rgb_matrix_decrease_speed_helper(bool write_to_eeprom) { rgb_matrix_set_spe
 void rgb_matrix_decrease_speed_noeeprom(void) { rgb_matrix_decrease_speed_helper(false); }
 void rgb_matrix_decrease_speed(void) { rgb_matrix_decrease_speed_helper(true); }
 
-led_flags_t rgb_matrix_get_flags(void) { return rgb_effect_params.flags; }
+led_flags_t rgb_matrix_get_flags(void) { return rgb_task.params.flags; }
 
-void rgb_matrix_set_flags(led_flags_t flags) { rgb_effect_params.flags = flags; }
+void rgb_matrix_set_flags(led_flags_t flags) { rgb_task.params.flags = flags; }
@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "rgb_matrix_types.h"
+#include "lighting_matrix.h"
 #include "color.h"
 #include "quantum.h"
 #include "rgblight_list.h"
@@ -126,6 +127,7 @@ uint8_t     rgb_matrix_is_enabled(void);
 void        rgb_matrix_mode(uint8_t mode);
 void        rgb_matrix_mode_noeeprom(uint8_t mode);
 uint8_t     rgb_matrix_get_mode(void);
+uint8_t     rgb_matrix_get_effect_flags(uint8_t mode);
 void        rgb_matrix_step(void);
 void        rgb_matrix_step_noeeprom(void);
 void        rgb_matrix_step_reverse(void);
@@ -216,12 +218,8 @@ extern const rgb_matrix_driver_t rgb_matrix_driver;
 
 extern rgb_config_t rgb_matrix_config;
 
-extern bool         g_suspend_state;
-extern uint32_t     g_rgb_timer;
-extern led_config_t g_led_config;
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-extern last_hit_t g_last_hit_tracker;
-#endif
+extern bool     g_suspend_state;
+extern uint32_t g_rgb_timer;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
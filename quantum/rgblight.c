@@ -125,6 +125,7 @@ static bool pre_suspend_enabled;
 
 #ifdef RGBLIGHT_USE_TIMER
 animation_status_t animation_status = {};
+static bool        animation_frame  = false;
 #endif
 
 #ifndef LED_ARRAY
@@ -785,6 +786,13 @@ __attribute__((weak)) void rgblight_call_driver(LED_TYPE *start_led, uint8_t num
 
 #ifndef RGBLIGHT_CUSTOM_DRIVER
 
+#    ifdef RGBLIGHT_USE_TIMER
+// Copy of the LED data last sent, so animation frames that leave the strip
+// unchanged never reach the (slow, interrupt blocking) driver.
+static LED_TYPE last_led[RGBLED_NUM];
+static uint8_t  last_num_leds = 0;
+#    endif
+
 void rgblight_set(void) {
     LED_TYPE *start_led;
     uint8_t   num_leds = rgblight_ranges.clipping_num_leds;
@@ -822,6 +830,14 @@ void rgblight_set(void) {
     start_led = led + rgblight_ranges.clipping_start_pos;
 #    endif
 
+#    ifdef RGBLIGHT_USE_TIMER
+    if (animation_frame && num_leds == last_num_leds && memcmp(start_led, last_led, num_leds * sizeof(LED_TYPE)) == 0) {
+        return;
+    }
+    memcpy(last_led, start_led, num_leds * sizeof(LED_TYPE));
+    last_num_leds = num_leds;
+#    endif
+
 #    ifdef RGBW
     for (uint8_t i = 0; i < num_leds; i++) {
         convert_rgb_to_rgbw(&start_led[i]);
@@ -998,12 +1014,17 @@ void rgblight_task(void) {
             effect_func   = (effect_func_t)rgblight_effect_twinkle;
         }
 #    endif
+        uint16_t now = sync_timer_read();
         if (animation_status.restart) {
-            animation_status.restart    = false;
-            animation_status.last_timer = sync_timer_read();
-            animation_status.pos16      = 0;  // restart signal to local each effect
+            animation_status.restart = false;
+#    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
+            // Start on the next interval boundary of the shared clock, so both halves render their frames in lockstep
+            animation_status.last_timer = now - (now % interval_time) + interval_time;
+#    else
+            animation_status.last_timer = now;
+#    endif
+            animation_status.pos16 = 0;  // restart signal to local each effect
         }
-        uint16_t now = sync_timer_read();
         if (timer_expired(now, animation_status.last_timer)) {
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
             static uint16_t report_last_timer = 0;
@@ -1020,7 +1041,9 @@ void rgblight_task(void) {
             oldpos16 = animation_status.pos16;
 #    endif
             animation_status.last_timer += interval_time;
+            animation_frame = true;
             effect_func(&animation_status);
+            animation_frame = false;
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
             if (animation_status.pos16 == 0 && oldpos16 != 0) {
                 tick_flag = true;
@@ -1229,24 +1252,25 @@ void rgblight_effect_knight(animation_status_t *anim) {
 #endif
 
 #ifdef RGBLIGHT_EFFECT_CHRISTMAS
-#    define CUBED(x) ((x) * (x) * (x))
+/* Hue keyframes for pos 0..32, precomputed from the cubic bezier
+ *   hue = 85 * pos^3 / (pos^3 + (32 - pos)^3)
+ * which eases in and out between red and green, leaving the interpolated colors visible as short as possible.
+ */
+static const uint8_t christmas_hue_keyframes[] PROGMEM = {0, 0, 0, 0, 0, 0, 1, 1, 3, 4, 7, 10, 15, 20, 27, 34, 42, 50, 57, 64, 69, 74, 77, 80, 81, 83, 83, 84, 84, 84, 84, 84, 85};
 
 /**
  * Christmas lights effect, with a smooth animation between red & green.
  */
 void rgblight_effect_christmas(animation_status_t *anim) {
     static int8_t increment = 1;
-    const uint8_t max_pos   = 32;
-    const uint8_t hue_green = 85;
+    const uint8_t max_pos   = sizeof(christmas_hue_keyframes) - 1;
+    const uint8_t hue_green = pgm_read_byte(&christmas_hue_keyframes[max_pos]);
 
-    uint32_t xa;
-    uint8_t  hue, val;
-    uint8_t  i;
+    uint8_t hue, val;
+    uint8_t i;
 
     // The effect works by animating anim->pos from 0 to 32 and back to 0.
-    // The pos is used in a cubic bezier formula to ease-in-out between red and green, leaving the interpolated colors visible as short as possible.
-    xa  = CUBED((uint32_t)anim->pos);
-    hue = ((uint32_t)hue_green) * xa / (xa + CUBED((uint32_t)(max_pos - anim->pos)));
+    hue = pgm_read_byte(&christmas_hue_keyframes[anim->pos]);
     // Additionally, these interpolated colors get shown with a slightly darker value, to make them less prominent than the main colors.
     val = 255 - (3 * (hue < hue_green / 2 ? hue : hue_green - hue) / 2);
 
@@ -1,44 +1,77 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
 #pragma once
 
-#include <util/atomic.h>
 #include <stdint.h>
 #include <stdbool.h>
 
-#ifndef RBUF_SIZE
-#    define RBUF_SIZE 32
-#endif
+/* Lock-free single-producer/single-consumer ring buffer
+ *
+ * RING_BUFFER_DEFINE(name, type, size) instantiates a static queue of `size` elements of `type`, together with
+ *   bool    name_enqueue(type value)   - producer side, returns false when full
+ *   bool    name_dequeue(type *value)  - consumer side, returns false when empty
+ *   bool    name_peek(type *value)     - consumer side, reads the oldest element without removing it
+ *   uint8_t name_count(void)
+ *   bool    name_has_data(void)
+ *   void    name_clear(void)           - consumer side, drops everything queued so far
+ *
+ * One context (usually an ISR) may enqueue while another (usually the main loop) dequeues, without disabling
+ * interrupts: the producer only ever writes `head`, the consumer only ever writes `tail`, and both are free-running
+ * single byte counters, so their loads and stores are atomic on AVR as well as ARM. `size` must be a power of two
+ * no larger than 128, which lets the counters wrap naturally and turns the index calculation into a mask.
+ *
+ * Any number of queues can be defined in the same translation unit, e.g.
+ *   RING_BUFFER_DEFINE(pbuf, uint8_t, 32);
+ */
 
-static uint8_t     rbuf[RBUF_SIZE];
-static uint8_t     rbuf_head = 0;
-static uint8_t     rbuf_tail = 0;
-static inline bool rbuf_enqueue(uint8_t data) {
-    bool ret = false;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        uint8_t next = (rbuf_head + 1) % RBUF_SIZE;
-        if (next != rbuf_tail) {
-            rbuf[rbuf_head] = data;
-            rbuf_head       = next;
-            ret             = true;
-        }
-    }
-    return ret;
-}
-static inline uint8_t rbuf_dequeue(void) {
-    uint8_t val = 0;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        if (rbuf_head != rbuf_tail) {
-            val       = rbuf[rbuf_tail];
-            rbuf_tail = (rbuf_tail + 1) % RBUF_SIZE;
-        }
-    }
+#define RING_BUFFER_BARRIER() __asm__ __volatile__("" ::: "memory")
 
-    return val;
-}
-static inline bool rbuf_has_data(void) {
-    bool has_data;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { has_data = (rbuf_head != rbuf_tail); }
-    return has_data;
-}
-static inline void rbuf_clear(void) {
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { rbuf_head = rbuf_tail = 0; }
-}
+#define RING_BUFFER_DEFINE(name, type, size)                                                    \
+    static type             name##_buf[(size)];                                                 \
+    static volatile uint8_t name##_head = 0;                                                    \
+    static volatile uint8_t name##_tail = 0;                                                    \
+    static inline uint8_t   name##_count(void) { return (uint8_t)(name##_head - name##_tail); } \
+    static inline bool      name##_has_data(void) { return name##_head != name##_tail; }        \
+    static inline bool      name##_enqueue(type value) {                                        \
+        uint8_t head = name##_head;                                                             \
+        if ((uint8_t)(head - name##_tail) >= (size)) {                                          \
+            return false;                                                                       \
+        }                                                                                       \
+        name##_buf[head & ((size)-1)] = value;                                                  \
+        RING_BUFFER_BARRIER();                                                                  \
+        name##_head = head + 1;                                                                 \
+        return true;                                                                            \
+    }                                                                                           \
+    static inline bool name##_peek(type *value) {                                               \
+        uint8_t tail = name##_tail;                                                             \
+        if (name##_head == tail) {                                                              \
+            return false;                                                                       \
+        }                                                                                       \
+        RING_BUFFER_BARRIER();                                                                  \
+        *value = name##_buf[tail & ((size)-1)];                                                 \
+        return true;                                                                            \
+    }                                                                                           \
+    static inline bool name##_dequeue(type *value) {                                            \
+        if (!name##_peek(value)) {                                                              \
+            return false;                                                                       \
+        }                                                                                       \
+        RING_BUFFER_BARRIER();                                                                  \
+        name##_tail = name##_tail + 1;                                                          \
+        return true;                                                                            \
+    }                                                                                           \
+    static inline void name##_clear(void) { name##_tail = name##_head; }                        \
+    _Static_assert((size) > 0 && (size) <= 128 && ((size) & ((size)-1)) == 0, #name ": ring buffer size must be a power of two no larger than 128")
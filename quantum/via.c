@@ -38,6 +38,13 @@
 #    define VIA_QMK_RGBLIGHT_ENABLE
 #endif
 
+// VIA_QMK_RGB_MATRIX_ENABLE is never set automatically, it must be set in keyboard-level
+// config.h for QMK RGB Matrix values to be handled here. They use the same value IDs as
+// QMK RGBLIGHT, so only one of the two can be handled.
+#if defined(VIA_QMK_RGB_MATRIX_ENABLE) && defined(VIA_QMK_RGBLIGHT_ENABLE)
+#    error "VIA_QMK_RGB_MATRIX_ENABLE cannot be used together with VIA_QMK_RGBLIGHT_ENABLE"
+#endif
+
 #include "quantum.h"
 
 #include "via.h"
@@ -59,6 +66,11 @@ void via_qmk_rgblight_set_value(uint8_t *data);
 void via_qmk_rgblight_get_value(uint8_t *data);
 #endif
 
+#if defined(VIA_QMK_RGB_MATRIX_ENABLE)
+void via_qmk_rgb_matrix_set_value(uint8_t *data);
+void via_qmk_rgb_matrix_get_value(uint8_t *data);
+#endif
+
 // Can be called in an overriding via_init_kb() to test if keyboard level code usage of
 // EEPROM is invalid and use/save defaults.
 bool via_eeprom_is_valid(void) {
@@ -288,10 +300,13 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
 #if defined(VIA_QMK_RGBLIGHT_ENABLE)
             via_qmk_rgblight_set_value(command_data);
 #endif
+#if defined(VIA_QMK_RGB_MATRIX_ENABLE)
+            via_qmk_rgb_matrix_set_value(command_data);
+#endif
 #if defined(VIA_CUSTOM_LIGHTING_ENABLE)
             raw_hid_receive_kb(data, length);
 #endif
-#if !defined(VIA_QMK_BACKLIGHT_ENABLE) && !defined(VIA_QMK_RGBLIGHT_ENABLE) && !defined(VIA_CUSTOM_LIGHTING_ENABLE)
+#if !defined(VIA_QMK_BACKLIGHT_ENABLE) && !defined(VIA_QMK_RGBLIGHT_ENABLE) && !defined(VIA_QMK_RGB_MATRIX_ENABLE) && !defined(VIA_CUSTOM_LIGHTING_ENABLE)
             // Return the unhandled state
             *command_id = id_unhandled;
 #endif
@@ -304,10 +319,13 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
 #if defined(VIA_QMK_RGBLIGHT_ENABLE)
             via_qmk_rgblight_get_value(command_data);
 #endif
+#if defined(VIA_QMK_RGB_MATRIX_ENABLE)
+            via_qmk_rgb_matrix_get_value(command_data);
+#endif
 #if defined(VIA_CUSTOM_LIGHTING_ENABLE)
             raw_hid_receive_kb(data, length);
 #endif
-#if !defined(VIA_QMK_BACKLIGHT_ENABLE) && !defined(VIA_QMK_RGBLIGHT_ENABLE) && !defined(VIA_CUSTOM_LIGHTING_ENABLE)
+#if !defined(VIA_QMK_BACKLIGHT_ENABLE) && !defined(VIA_QMK_RGBLIGHT_ENABLE) && !defined(VIA_QMK_RGB_MATRIX_ENABLE) && !defined(VIA_CUSTOM_LIGHTING_ENABLE)
             // Return the unhandled state
             *command_id = id_unhandled;
 #endif
@@ -320,10 +338,13 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
 #if defined(VIA_QMK_RGBLIGHT_ENABLE)
             eeconfig_update_rgblight_current();
 #endif
+#if defined(VIA_QMK_RGB_MATRIX_ENABLE)
+            eeconfig_update_rgb_matrix();
+#endif
 #if defined(VIA_CUSTOM_LIGHTING_ENABLE)
             raw_hid_receive_kb(data, length);
 #endif
-#if !defined(VIA_QMK_BACKLIGHT_ENABLE) && !defined(VIA_QMK_RGBLIGHT_ENABLE) && !defined(VIA_CUSTOM_LIGHTING_ENABLE)
+#if !defined(VIA_QMK_BACKLIGHT_ENABLE) && !defined(VIA_QMK_RGBLIGHT_ENABLE) && !defined(VIA_QMK_RGB_MATRIX_ENABLE) && !defined(VIA_CUSTOM_LIGHTING_ENABLE)
             // Return the unhandled state
             *command_id = id_unhandled;
 #endif
@@ -489,3 +510,59 @@ void via_qmk_rgblight_set_value(uint8_t *data) {
 }
 
 #endif  // #if defined(VIA_QMK_RGBLIGHT_ENABLE)
+
+#if defined(VIA_QMK_RGB_MATRIX_ENABLE)
+
+void via_qmk_rgb_matrix_get_value(uint8_t *data) {
+    uint8_t *value_id   = &(data[0]);
+    uint8_t *value_data = &(data[1]);
+    switch (*value_id) {
+        case id_qmk_rgblight_brightness: {
+            value_data[0] = rgb_matrix_get_val();
+            break;
+        }
+        case id_qmk_rgblight_effect: {
+            value_data[0] = rgb_matrix_is_enabled() ? rgb_matrix_get_mode() : 0;
+            break;
+        }
+        case id_qmk_rgblight_effect_speed: {
+            value_data[0] = rgb_matrix_get_speed();
+            break;
+        }
+        case id_qmk_rgblight_color: {
+            value_data[0] = rgb_matrix_get_hue();
+            value_data[1] = rgb_matrix_get_sat();
+            break;
+        }
+    }
+}
+
+void via_qmk_rgb_matrix_set_value(uint8_t *data) {
+    uint8_t *value_id   = &(data[0]);
+    uint8_t *value_data = &(data[1]);
+    switch (*value_id) {
+        case id_qmk_rgblight_brightness: {
+            rgb_matrix_sethsv_noeeprom(rgb_matrix_get_hue(), rgb_matrix_get_sat(), value_data[0]);
+            break;
+        }
+        case id_qmk_rgblight_effect: {
+            if (value_data[0] == 0) {
+                rgb_matrix_disable_noeeprom();
+            } else if (value_data[0] < RGB_MATRIX_EFFECT_MAX) {
+                rgb_matrix_enable_noeeprom();
+                rgb_matrix_mode_noeeprom(value_data[0]);
+            }
+            break;
+        }
+        case id_qmk_rgblight_effect_speed: {
+            rgb_matrix_set_speed_noeeprom(value_data[0]);
+            break;
+        }
+        case id_qmk_rgblight_color: {
+            rgb_matrix_sethsv_noeeprom(value_data[0], value_data[1], rgb_matrix_get_val());
+            break;
+        }
+    }
+}
+
+#endif  // #if defined(VIA_QMK_RGB_MATRIX_ENABLE)
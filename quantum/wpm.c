@@ -18,14 +18,48 @@
 #include "wpm.h"
 
 // WPM Stuff
-static uint8_t  current_wpm = 0;
-static uint8_t  latest_wpm  = 0;
-static uint16_t wpm_timer   = 0;
+static uint8_t        current_wpm     = 0;
+static uint8_t        latest_wpm      = 0;
+static uint16_t       wpm_timer       = 0;
+static deferred_token wpm_decay_token = INVALID_DEFERRED_TOKEN;
 
 // This smoothing is 40 keystrokes
 static const float wpm_smoothing = 0.0487;
 
-void set_current_wpm(uint8_t new_wpm) { current_wpm = new_wpm; }
+#define WPM_DECAY_INTERVAL 1000
+
+// Decays the WPM once a second without typing, and keeps doing so every second until it reaches 0
+static uint32_t wpm_decay_callback(uint32_t trigger_time, void *cb_arg) {
+    current_wpm = (0 - current_wpm) * wpm_smoothing + current_wpm;
+    wpm_timer   = timer_read();
+    if (current_wpm == 0) {
+        // the next counted key schedules the decay again
+        wpm_decay_token = INVALID_DEFERRED_TOKEN;
+        return 0;
+    }
+    return WPM_DECAY_INTERVAL + 1;
+}
+
+static void restart_wpm_decay(void) {
+    if (!extend_deferred_exec(wpm_decay_token, WPM_DECAY_INTERVAL + 1)) {
+        wpm_decay_token = defer_exec(WPM_DECAY_INTERVAL + 1, wpm_decay_callback, NULL);
+    }
+}
+
+// Runs a decay that is due but was never scheduled, for keymaps that still call this from matrix_scan_user()
+void decay_wpm(void) {
+    if (current_wpm && wpm_decay_token == INVALID_DEFERRED_TOKEN && timer_elapsed(wpm_timer) > WPM_DECAY_INTERVAL) {
+        wpm_decay_callback(0, NULL);
+        if (current_wpm) {
+            restart_wpm_decay();
+        }
+    }
+}
+
+void set_current_wpm(uint8_t new_wpm) {
+    current_wpm = new_wpm;
+    restart_wpm_decay();
+}
 
 uint8_t get_current_wpm(void) { return current_wpm; }
 
@@ -53,12 +87,6 @@ void update_wpm(uint16_t keycode) {
             current_wpm = (latest_wpm - current_wpm) * wpm_smoothing + current_wpm;
         }
         wpm_timer = timer_read();
-    }
-}
-
-void decay_wpm(void) {
-    if (timer_elapsed(wpm_timer) > 1000) {
-        current_wpm = (0 - current_wpm) * wpm_smoothing + current_wpm;
-        wpm_timer   = timer_read();
+        restart_wpm_decay();
     }
 }
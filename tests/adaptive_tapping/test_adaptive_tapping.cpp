@@ -0,0 +1,101 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "adaptive_tapping.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class AdaptiveTapping : public TestFixture {
+   protected:
+    AdaptiveTapping() { adaptive_tapping_reset(); }
+
+    void record_taps(uint16_t keycode, uint16_t duration, uint8_t count) {
+        for (uint8_t i = 0; i < count; i++) {
+            adaptive_tapping_record_tap(keycode, duration);
+        }
+    }
+};
+
+TEST_F(AdaptiveTapping, ConfiguredTermIsUsedUntilEnoughSamples) {
+    record_taps(KC_A, 150, ADAPTIVE_TAPPING_TERM_SAMPLES - 1);
+    EXPECT_EQ(adaptive_tapping_term(KC_A, TAPPING_TERM), TAPPING_TERM);
+    EXPECT_EQ(adaptive_tapping_term(KC_B, TAPPING_TERM), TAPPING_TERM);
+}
+
+TEST_F(AdaptiveTapping, LearnedTermSettlesJustAboveSteadyTaps) {
+    record_taps(KC_A, 150, ADAPTIVE_TAPPING_TERM_SAMPLES);
+    uint16_t term = adaptive_tapping_term(KC_A, TAPPING_TERM);
+    EXPECT_GE(term, 150);
+    EXPECT_LT(term, TAPPING_TERM);
+}
+
+TEST_F(AdaptiveTapping, LearnedTermIsLimitedByTheMinimumAndTheConfiguredTerm) {
+    record_taps(KC_A, 20, ADAPTIVE_TAPPING_TERM_SAMPLES);
+    EXPECT_EQ(adaptive_tapping_term(KC_A, TAPPING_TERM), ADAPTIVE_TAPPING_TERM_MIN);
+
+    record_taps(KC_B, TAPPING_TERM - 1, ADAPTIVE_TAPPING_TERM_SAMPLES);
+    EXPECT_EQ(adaptive_tapping_term(KC_B, TAPPING_TERM), TAPPING_TERM);
+}
+
+TEST_F(AdaptiveTapping, UnevenTapsKeepALongerTerm) {
+    for (uint8_t i = 0; i < ADAPTIVE_TAPPING_TERM_SAMPLES / 2; i++) {
+        adaptive_tapping_record_tap(KC_A, 130);
+        adaptive_tapping_record_tap(KC_A, 170);
+        adaptive_tapping_record_tap(KC_B, 150);
+        adaptive_tapping_record_tap(KC_B, 150);
+    }
+    EXPECT_GT(adaptive_tapping_term(KC_A, TAPPING_TERM), adaptive_tapping_term(KC_B, TAPPING_TERM));
+}
+
+TEST_F(AdaptiveTapping, KeyWithoutASlotWearsDownTheLeastUsedOne) {
+    for (uint8_t key = 0; key < ADAPTIVE_TAPPING_TERM_KEYS; key++) {
+        record_taps(KC_A + key, 20, ADAPTIVE_TAPPING_TERM_SAMPLES + key);
+    }
+    // KC_A has the fewest samples, each tap of the new key takes one away
+    record_taps(KC_Z, 20, ADAPTIVE_TAPPING_TERM_SAMPLES);
+    EXPECT_EQ(adaptive_tapping_term(KC_A, TAPPING_TERM), TAPPING_TERM);
+    EXPECT_EQ(adaptive_tapping_term(KC_Z, TAPPING_TERM), TAPPING_TERM);
+    EXPECT_EQ(adaptive_tapping_term(KC_B, TAPPING_TERM), ADAPTIVE_TAPPING_TERM_MIN);
+
+    record_taps(KC_Z, 20, ADAPTIVE_TAPPING_TERM_SAMPLES);
+    EXPECT_EQ(adaptive_tapping_term(KC_Z, TAPPING_TERM), ADAPTIVE_TAPPING_TERM_MIN);
+}
+
+TEST_F(AdaptiveTapping, ModTapIsHeldAfterTheLearnedTerm) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (uint8_t i = 0; i < ADAPTIVE_TAPPING_TERM_SAMPLES; i++) {
+        press_key(0, 0);
+        idle_for(50);
+        release_key(0, 0);
+        idle_for(TAPPING_TERM + 1);
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(ADAPTIVE_TAPPING_TERM_MIN);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+}
@@ -18,3 +18,5 @@
 
 #define MATRIX_ROWS 4
 #define MATRIX_COLS 10
+
+#define HOLD_TAP_STRATEGY_PER_KEY
@@ -95,3 +95,164 @@ TEST_F(Tapping, ANewTapWithinTappingTermIsBuggy) {
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).Times(1);
     idle_for(TAPPING_TERM);
 }
+
+static hold_tap_strategy_t hold_tap_strategy       = HOLD_TAP_DEFAULT;
+static unsigned            hold_tap_strategy_calls = 0;
+
+extern "C" hold_tap_strategy_t get_hold_tap_strategy(uint16_t keycode, keyrecord_t *record) {
+    hold_tap_strategy_calls++;
+    return hold_tap_strategy;
+}
+
+// Each row is a hand, so KC_A is on the same hand as SFT_T(KC_P) and KC_EQL is not
+extern "C" bool get_hold_tap_same_hand(keypos_t a, keypos_t b) { return a.row == b.row; }
+
+class HoldTapStrategy : public Tapping {
+   protected:
+    HoldTapStrategy() { hold_tap_strategy_calls = 0; }
+    ~HoldTapStrategy() { hold_tap_strategy = HOLD_TAP_DEFAULT; }
+};
+
+TEST_F(HoldTapStrategy, HoldPreferredIsAHoldAsSoonAsAnotherKeyIsPressed) {
+    TestDriver driver;
+    InSequence s;
+    hold_tap_strategy = HOLD_TAP_HOLD_PREFERRED;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(HoldTapStrategy, BalancedIsAHoldOnceAnotherKeyIsTyped) {
+    TestDriver driver;
+    InSequence s;
+    hold_tap_strategy = HOLD_TAP_BALANCED;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(HoldTapStrategy, TapPreferredIsATapWhenReleasedWithinTheTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+    hold_tap_strategy = HOLD_TAP_TAP_PREFERRED;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P, KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(HoldTapStrategy, PositionalIsATapAsSoonAsASameHandKeyIsPressed) {
+    TestDriver driver;
+    InSequence s;
+    hold_tap_strategy = HOLD_TAP_POSITIONAL;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P, KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    run_one_scan_loop();
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(HoldTapStrategy, PositionalIsBalancedForAKeyOnTheOtherHand) {
+    TestDriver driver;
+    InSequence s;
+    hold_tap_strategy = HOLD_TAP_POSITIONAL;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(0, 1);
+    run_one_scan_loop();
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_EQL)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(HoldTapStrategy, StrategyIsNotAskedForWhileNoOtherKeyIsPressed) {
+    TestDriver driver;
+    InSequence s;
+    hold_tap_strategy = HOLD_TAP_POSITIONAL;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM / 2);
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_EQ(hold_tap_strategy_calls, 0u);
+}
+
+TEST_F(HoldTapStrategy, OverflowingTheWaitingBufferClearsAllStates) {
+    TestDriver driver;
+    hold_tap_strategy = HOLD_TAP_TAP_PREFERRED;
+
+    // Nothing but empty reports until the keyboard has recovered
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(testing::AnyNumber());
+    press_key(7, 0);
+    run_one_scan_loop();
+    // Every event is held back until SFT_T(KC_P) is decided, one more than fits in the waiting buffer
+    for (int i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        press_key(0, 0);
+        run_one_scan_loop();
+        release_key(0, 0);
+        run_one_scan_loop();
+    }
+    release_key(7, 0);
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
@@ -0,0 +1,166 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::AtLeast;
+using testing::InSequence;
+
+class DynamicMacro : public TestFixture {
+   protected:
+    void tap_key(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+
+    // Records A held for 50 ms, followed by a tap of B
+    void record_macro(TestDriver& driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        tap_key(3);
+        press_key(0, 0);
+        run_one_scan_loop();
+        idle_for(50);
+        release_key(0, 0);
+        run_one_scan_loop();
+        tap_key(1);
+        tap_key(4);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+};
+
+TEST_F(DynamicMacro, LayerKeyReleasedDuringPlaybackTurnsTheLayerOff) {
+    TestDriver driver;
+    record_macro(driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    {
+        InSequence s;
+        // The macro is played on the layers it was recorded on, not on layer 1
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    }
+    press_key(2, 0);
+    run_one_scan_loop();
+    tap_key(5);
+    idle_for(10);
+    release_key(2, 0);
+    run_one_scan_loop();
+    idle_for(100);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_FALSE(layer_state_is(1));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    press_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(DynamicMacro, KeysTypedDuringPlaybackAreSentAfterTheMacro) {
+    TestDriver driver;
+    record_macro(driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    }
+    tap_key(5);
+    idle_for(10);
+    tap_key(0);
+    idle_for(100);
+}
+
+TEST_F(DynamicMacro, KeyLockTypedDuringPlaybackLocksTheKeyTypedAfterIt) {
+    TestDriver driver;
+    record_macro(driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    }
+    tap_key(5);
+    idle_for(10);
+    tap_key(6);
+    tap_key(0);
+    idle_for(100);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // A is held by the key lock, so pressing it again only unlocks it
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).Times(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    tap_key(0);
+}
+
+TEST_F(DynamicMacro, LongDelaysArePlayedBack) {
+    TestDriver driver;
+
+    // A held for 5 seconds takes a three byte delay
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(3);
+    press_key(0, 0);
+    run_one_scan_loop();
+    idle_for(5000);
+    release_key(0, 0);
+    run_one_scan_loop();
+    tap_key(4);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    tap_key(5);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(4900);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AtLeast(1));
+    idle_for(200);
+}
+
+TEST_F(DynamicMacro, RecordingStopsWhenTheBufferIsFull) {
+    TestDriver driver;
+
+    // Quick taps take 3 bytes per event, and an event is only stored while there is room for the largest one
+    const int buffer_size = DYNAMIC_MACRO_SIZE * sizeof(keyrecord_t);
+    const int events      = (buffer_size - 6) / 3 + 1;
+    const int taps        = events / 2;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(3);
+    for (int i = 0; i < taps + 5; i++) {
+        tap_key(1);
+    }
+    tap_key(4);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).Times(taps);
+    tap_key(5);
+    idle_for(buffer_size);
+}
@@ -0,0 +1,114 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class DynamicMacroEeprom : public TestFixture {
+   protected:
+    DynamicMacroEeprom() {
+        uint8_t invalid = 0;
+        dynamic_keymap_reset();
+        dynamic_keymap_recorded_macro_set_buffer(0, 1, &invalid);
+    }
+
+    void tap_key(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+
+    // Records A held for 50 ms, followed by a tap of B, which takes 13 bytes
+    void record_macro(TestDriver& driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        tap_key(3);
+        press_key(0, 0);
+        run_one_scan_loop();
+        idle_for(50);
+        release_key(0, 0);
+        run_one_scan_loop();
+        tap_key(1);
+        tap_key(4);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+
+    // Records three taps of B, which take 18 bytes
+    void record_long_macro(TestDriver& driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        tap_key(3);
+        tap_key(1);
+        tap_key(1);
+        tap_key(1);
+        tap_key(4);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+
+    void expect_header(uint8_t magic, uint16_t length1, uint16_t length2) {
+        uint8_t header[5];
+        dynamic_keymap_recorded_macro_get_buffer(0, sizeof(header), header);
+        EXPECT_EQ(header[0], magic);
+        EXPECT_EQ(header[1] | (header[2] << 8), length1);
+        EXPECT_EQ(header[3] | (header[4] << 8), length2);
+    }
+};
+
+TEST_F(DynamicMacroEeprom, MacroThatFillsTheSpaceIsSaved) {
+    TestDriver driver;
+    record_macro(driver);
+    expect_header(0xD3, 13, 0);
+}
+
+TEST_F(DynamicMacroEeprom, MacroTooLongToSaveKeepsThePreviousOne) {
+    TestDriver driver;
+    record_macro(driver);
+    record_long_macro(driver);
+    expect_header(0xD3, 13, 0);
+
+    // Loading replaces the long macro with the saved one
+    dynamic_macro_init();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    }
+    tap_key(5);
+    idle_for(100);
+}
+
+TEST_F(DynamicMacroEeprom, InvalidHeaderIsNotLoaded) {
+    TestDriver driver;
+    record_macro(driver);
+
+    uint8_t invalid = 0;
+    dynamic_keymap_recorded_macro_set_buffer(0, 1, &invalid);
+    record_long_macro(driver);
+    expect_header(0, 13, 0);
+
+    dynamic_macro_init();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).Times(3);
+    tap_key(5);
+    idle_for(100);
+}
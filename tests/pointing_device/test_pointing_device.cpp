@@ -0,0 +1,76 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "test_common.hpp"
+
+extern "C" {
+#include "pointing_device.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+static bool           compare_last_report = false;
+static report_mouse_t last_report         = {};
+
+// Like a keymap that only sends reports that differ from the one it saw last
+extern "C" bool has_mouse_report_changed(report_mouse_t new_report, report_mouse_t old_report) {
+    if (compare_last_report) {
+        bool changed = memcmp(&new_report, &last_report, sizeof(report_mouse_t)) != 0;
+        last_report  = new_report;
+        return changed;
+    }
+    return new_report.buttons != old_report.buttons || new_report.x || new_report.y || new_report.v || new_report.h;
+}
+
+MATCHER_P2(MouseMotion, x, y, "") { return arg.x == x && arg.y == y; }
+
+class PointingDevice : public TestFixture {
+   protected:
+    ~PointingDevice() {
+        compare_last_report = false;
+        last_report         = {};
+    }
+};
+
+TEST_F(PointingDevice, LargeMotionIsSplitOverReports) {
+    TestDriver driver;
+    InSequence s;
+
+    pointing_device_add_motion(300, -5, 0, 0);
+    EXPECT_CALL(driver, send_mouse_mock(MouseMotion(127, -5)));
+    EXPECT_CALL(driver, send_mouse_mock(MouseMotion(127, 0)));
+    EXPECT_CALL(driver, send_mouse_mock(MouseMotion(46, 0)));
+    idle_for(3);
+    EXPECT_FALSE(pointing_device_has_pending_motion());
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    idle_for(3);
+}
+
+TEST_F(PointingDevice, EqualConsecutiveChunksAreNotLost) {
+    TestDriver driver;
+    InSequence s;
+    compare_last_report = true;
+
+    pointing_device_add_motion(300, 0, 0, 0);
+    EXPECT_CALL(driver, send_mouse_mock(MouseMotion(127, 0)));
+    EXPECT_CALL(driver, send_mouse_mock(MouseMotion(127, 0)));
+    EXPECT_CALL(driver, send_mouse_mock(MouseMotion(46, 0)));
+    idle_for(3);
+    EXPECT_FALSE(pointing_device_has_pending_motion());
+}
@@ -0,0 +1,81 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "test_common.hpp"
+
+extern "C" {
+#include "process_steno.h"
+}
+
+// TX Bolt bytes for the keys on row 0: R- and A- share group 1, S- is in group 0
+#define BOLT_R_L 0b01000001
+#define BOLT_A_L 0b01000010
+#define BOLT_S_L 0b00000001
+
+static uint8_t sent_chord[6];
+static int     sent_chords = 0;
+
+extern "C" bool send_steno_chord_user(steno_mode_t mode, uint8_t chord[6]) {
+    memcpy(sent_chord, chord, sizeof(sent_chord));
+    sent_chords++;
+    return false;
+}
+
+class Steno : public TestFixture {
+   protected:
+    Steno() {
+        steno_set_mode(STENO_MODE_BOLT);
+        memset(sent_chord, 0, sizeof(sent_chord));
+        sent_chords = 0;
+    }
+};
+
+TEST_F(Steno, BoltReleaseKeepsTheGroupOfHeldKeys) {
+    TestDriver driver;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(steno_get_state()[1], BOLT_A_L);
+
+    release_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(sent_chords, 1);
+    EXPECT_EQ(sent_chord[1], BOLT_R_L | BOLT_A_L);
+}
+
+TEST_F(Steno, BoltReleasingLastKeyOfGroupClearsItsByte) {
+    TestDriver driver;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(2, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(steno_get_state()[0], BOLT_S_L);
+    EXPECT_EQ(steno_get_state()[1], 0);
+
+    release_key(2, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(sent_chords, 1);
+    EXPECT_EQ(sent_chord[0], BOLT_S_L);
+    EXPECT_EQ(sent_chord[1], BOLT_R_L);
+}
@@ -796,7 +796,7 @@ void register_code(uint8_t code) {
                 // Force a new key press if the key is already pressed
                 // without this, keys with the same keycode, but different
                 // modifiers will be reported incorrectly, see issue #1708
-                if (is_key_pressed(keyboard_report, code)) {
+                if (is_keycode_held(code)) {
                     del_key(code);
                     send_keyboard_report();
                 }
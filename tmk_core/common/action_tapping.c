@@ -6,6 +6,10 @@
 #include "keycode.h"
 #include "timer.h"
 
+#ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+#    include "adaptive_tapping.h"
+#endif
+
 #ifdef DEBUG_ACTION
 #    include "debug.h"
 #else
@@ -22,6 +26,14 @@
 __attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) { return TAPPING_TERM; }
 
 #    ifdef TAPPING_TERM_PER_KEY
+#        define GET_TAPPING_TERM(keycode, record) get_tapping_term(keycode, record)
+#    else
+#        define GET_TAPPING_TERM(keycode, record) TAPPING_TERM
+#    endif
+
+#    ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+#        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < adaptive_tapping_key_term())
+#    elif defined(TAPPING_TERM_PER_KEY)
 #        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < get_tapping_term(get_event_keycode(tapping_key.event, false), &tapping_key))
 #    else
 #        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < TAPPING_TERM)
@@ -35,6 +47,18 @@ __attribute__((weak)) bool get_tapping_force_hold(uint16_t keycode, keyrecord_t
 __attribute__((weak)) bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) { return false; }
 #    endif
 
+#    ifdef HOLD_TAP_STRATEGY_PER_KEY
+__attribute__((weak)) hold_tap_strategy_t get_hold_tap_strategy(uint16_t keycode, keyrecord_t *record) { return HOLD_TAP_DEFAULT; }
+
+__attribute__((weak)) bool get_hold_tap_same_hand(keypos_t a, keypos_t b) {
+#        ifdef SPLIT_KEYBOARD
+    return (a.row < MATRIX_ROWS / 2) == (b.row < MATRIX_ROWS / 2);
+#        else
+    return (a.col < MATRIX_COLS / 2) == (b.col < MATRIX_COLS / 2);
+#        endif
+}
+#    endif
+
 static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
@@ -49,11 +73,54 @@ static void waiting_buffer_scan_tap(void);
 static void debug_tapping_key(void);
 static void debug_waiting_buffer(void);
 
+#    ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+// Tap-hold key pressed most recently, cleared as soon as any other key is pressed
+static keyrecord_t adaptive_tapping_key = {};
+
+// Term of the current tapping key event, so it is looked up once per event rather than on every scan
+static keyevent_t adaptive_term_event = {};
+static uint16_t   adaptive_term       = TAPPING_TERM;
+
+static uint16_t adaptive_tapping_key_term(void) {
+    if (!KEYEQ(adaptive_term_event.key, tapping_key.event.key) || adaptive_term_event.time != tapping_key.event.time || adaptive_term_event.pressed != tapping_key.event.pressed) {
+        uint16_t keycode    = get_event_keycode(tapping_key.event, false);
+        adaptive_term       = adaptive_tapping_term(keycode, GET_TAPPING_TERM(keycode, &tapping_key));
+        adaptive_term_event = tapping_key.event;
+    }
+    return adaptive_term;
+}
+
+/* Feeds the adaptive tapping term with every clean tap
+ *
+ * Sees events in the order they were typed, before they are queued or resolved. A tap-hold key released within
+ * its configured term with no other key pressed in between counts as a tap, even when a shorter learned term had
+ * already turned it into a hold, so that the learned term can grow back as well as shrink.
+ */
+static void adaptive_tapping_observe(keyrecord_t *record) {
+    if (IS_NOEVENT(record->event)) {
+        return;
+    }
+    if (record->event.pressed) {
+        adaptive_tapping_key = is_tap_key(record->event.key) ? *record : (keyrecord_t){};
+    } else if (!IS_NOEVENT(adaptive_tapping_key.event) && KEYEQ(record->event.key, adaptive_tapping_key.event.key)) {
+        uint16_t keycode  = get_event_keycode(adaptive_tapping_key.event, false);
+        uint16_t duration = TIMER_DIFF_16(record->event.time, adaptive_tapping_key.event.time);
+        if (duration < GET_TAPPING_TERM(keycode, &adaptive_tapping_key)) {
+            adaptive_tapping_record_tap(keycode, duration);
+        }
+        adaptive_tapping_key = (keyrecord_t){};
+    }
+}
+#    endif
+
 /** \brief Action Tapping Process
  *
  * FIXME: Needs doc
  */
 void action_tapping_process(keyrecord_t record) {
+#    ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+    adaptive_tapping_observe(&record);
+#    endif
     if (process_tapping(&record)) {
         if (!IS_NOEVENT(record.event)) {
             debug("processed: ");
@@ -90,6 +157,34 @@ void action_tapping_process(keyrecord_t record) {
     }
 }
 
+#    if defined(TAPPING_TERM_PER_KEY) || (TAPPING_TERM >= 500) || defined(PERMISSIVE_HOLD) || defined(PERMISSIVE_HOLD_PER_KEY) || defined(HOLD_TAP_STRATEGY_PER_KEY)
+/* Whether the tapping key settles as a hold once another key is typed (pressed and released) within the tapping term.
+ * Only asked for such a release, so the per key functions are not called on every scan.
+ */
+static bool tapping_key_hold_when_typed(keyrecord_t *keyp) {
+#        ifdef HOLD_TAP_STRATEGY_PER_KEY
+    // A key with its own strategy ignores the global settings, see the interrupt handling in process_tapping()
+    hold_tap_strategy_t strategy = get_hold_tap_strategy(get_event_keycode(tapping_key.event, false), &tapping_key);
+    if (strategy != HOLD_TAP_DEFAULT) {
+        return strategy != HOLD_TAP_TAP_PREFERRED;
+    }
+#        endif
+    return (
+#        ifdef TAPPING_TERM_PER_KEY
+               get_tapping_term(get_event_keycode(tapping_key.event, false), keyp)
+#        else
+               TAPPING_TERM
+#        endif
+               >= 500)
+#        ifdef PERMISSIVE_HOLD_PER_KEY
+           || get_permissive_hold(get_event_keycode(tapping_key.event, false), keyp)
+#        elif defined(PERMISSIVE_HOLD)
+           || true
+#        endif
+        ;
+}
+#    endif
+
 /** \brief Tapping
  *
  * Rule: Tap key is typed(pressed and released) within TAPPING_TERM.
@@ -119,22 +214,8 @@ bool process_tapping(keyrecord_t *keyp) {
                  * This can register the key before settlement of tapping,
                  * useful for long TAPPING_TERM but may prevent fast typing.
                  */
-#    if defined(TAPPING_TERM_PER_KEY) || (TAPPING_TERM >= 500) || defined(PERMISSIVE_HOLD) || defined(PERMISSIVE_HOLD_PER_KEY)
-                else if (((
-#        ifdef TAPPING_TERM_PER_KEY
-                              get_tapping_term(get_event_keycode(tapping_key.event, false), keyp)
-#        else
-                              TAPPING_TERM
-#        endif
-                              >= 500)
-
-#        ifdef PERMISSIVE_HOLD_PER_KEY
-                          || get_permissive_hold(get_event_keycode(tapping_key.event, false), keyp)
-#        elif defined(PERMISSIVE_HOLD)
-                          || true
-#        endif
-                              ) &&
-                         IS_RELEASED(event) && waiting_buffer_typed(event)) {
+#    if defined(TAPPING_TERM_PER_KEY) || (TAPPING_TERM >= 500) || defined(PERMISSIVE_HOLD) || defined(PERMISSIVE_HOLD_PER_KEY) || defined(HOLD_TAP_STRATEGY_PER_KEY)
+                else if (IS_RELEASED(event) && waiting_buffer_typed(event) && tapping_key_hold_when_typed(keyp)) {
                     debug("Tapping: End. No tap. Interfered by typing key\n");
                     process_record(&tapping_key);
                     tapping_key = (keyrecord_t){};
@@ -169,6 +250,32 @@ bool process_tapping(keyrecord_t *keyp) {
                 } else {
                     // set interrupted flag when other key preesed during tapping
                     if (event.pressed) {
+#    ifdef HOLD_TAP_STRATEGY_PER_KEY
+                        switch (get_hold_tap_strategy(get_event_keycode(tapping_key.event, false), &tapping_key)) {
+                            case HOLD_TAP_HOLD_PREFERRED:
+                                // settle as hold right away, the pressed key is processed after it from the buffer
+                                debug("Tapping: End. No tap. Hold preferred, other key pressed\n");
+                                process_record(&tapping_key);
+                                tapping_key = (keyrecord_t){};
+                                debug_tapping_key();
+                                return false;
+                            case HOLD_TAP_POSITIONAL:
+                                if (get_hold_tap_same_hand(tapping_key.event.key, event.key)) {
+                                    // rolling over keys of the same hand is typing, settle as tap right away
+                                    debug("Tapping: First tap(0->1). Same hand key pressed\n");
+                                    tapping_key.tap.count = 1;
+                                    process_record(&tapping_key);
+                                    debug_tapping_key();
+                                    return false;
+                                }
+                                break;
+                            case HOLD_TAP_TAP_PREFERRED:
+                                // not marked as interrupted, so only the tapping term turns it into a hold
+                                return false;
+                            default:
+                                break;
+                        }
+#    endif
                         tapping_key.tap.interrupted = true;
                     }
                     // enqueue
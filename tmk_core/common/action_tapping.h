@@ -27,7 +27,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* size of the queue of events held back while a tap key is undecided */
+#ifndef WAITING_BUFFER_SIZE
+#    ifdef HOLD_TAP_STRATEGY_PER_KEY
+#        define WAITING_BUFFER_SIZE 16
+#    else
+#        define WAITING_BUFFER_SIZE 8
+#    endif
+#endif
+
+/* how a tap key is decided when other keys are pressed before the tapping term, see get_hold_tap_strategy() */
+typedef enum {
+    HOLD_TAP_DEFAULT,         // follow PERMISSIVE_HOLD, IGNORE_MOD_TAP_INTERRUPT and their per key settings
+    HOLD_TAP_BALANCED,        // hold once another key is pressed and released
+    HOLD_TAP_HOLD_PREFERRED,  // hold as soon as another key is pressed
+    HOLD_TAP_TAP_PREFERRED,   // hold only after the tapping term
+    HOLD_TAP_POSITIONAL,      // tap when a key of the same hand is pressed, otherwise balanced
+} hold_tap_strategy_t;
 
 #ifndef NO_ACTION_TAPPING
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
@@ -38,4 +54,7 @@ bool     get_permissive_hold(uint16_t keycode, keyrecord_t *record);
 bool     get_ignore_mod_tap_interrupt(uint16_t keycode, keyrecord_t *record);
 bool     get_tapping_force_hold(uint16_t keycode, keyrecord_t *record);
 bool     get_retro_tapping(uint16_t keycode, keyrecord_t *record);
+
+hold_tap_strategy_t get_hold_tap_strategy(uint16_t keycode, keyrecord_t *record);
+bool                get_hold_tap_same_hand(keypos_t a, keypos_t b);
 #endif
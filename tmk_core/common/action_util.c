@@ -42,9 +42,15 @@ static int8_t cb_count = 0;
 // report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
 
+keycode_bitmap_t held_keycodes = {0};
+
+extern inline bool keycode_bitmap_get(const keycode_bitmap_t bitmap, uint8_t code);
+extern inline void keycode_bitmap_set(keycode_bitmap_t bitmap, uint8_t code);
+extern inline void keycode_bitmap_clear(keycode_bitmap_t bitmap, uint8_t code);
 extern inline void add_key(uint8_t key);
 extern inline void del_key(uint8_t key);
 extern inline void clear_keys(void);
+extern inline bool is_keycode_held(uint8_t key);
 
 #ifndef NO_ACTION_ONESHOT
 static uint8_t oneshot_mods        = 0;
@@ -201,7 +207,7 @@ void send_keyboard_report(void) {
         }
 #    endif
         keyboard_report->mods |= oneshot_mods;
-        if (has_anykey(keyboard_report)) {
+        if (has_any_keycode_held()) {
             clear_oneshot_mods();
         }
     }
@@ -385,3 +391,41 @@ __attribute__((weak)) void oneshot_layer_changed_kb(uint8_t layer) { oneshot_lay
  * FIXME: needs doc
  */
 uint8_t has_anymod(void) { return bitpop(real_mods); }
+
+/** \brief Checks whether any of the keycodes in a bitmap is set
+ */
+bool keycode_bitmap_any(const keycode_bitmap_t bitmap) {
+    for (uint8_t i = 0; i < KEYCODE_BITMAP_WORDS; i++) {
+        if (bitmap[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** \brief Counts the keycodes set in a bitmap
+ */
+uint8_t keycode_bitmap_count(const keycode_bitmap_t bitmap) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < KEYCODE_BITMAP_WORDS; i++) {
+        count += bitpop32(bitmap[i]);
+    }
+    return count;
+}
+
+/** \brief Checks whether any basic keycode is held
+ */
+bool has_any_keycode_held(void) { return keycode_bitmap_any(held_keycodes); }
+
+/** \brief Checks whether any of KC_A to KC_Z is held
+ */
+bool has_alpha_keycode_held(void) {
+    // KC_A to KC_Z are bits 4 to 29 of the first word
+    return held_keycodes[0] & 0x3FFFFFF0;
+}
+
+/** \brief Counts the basic keycodes held
+ *
+ * Modifiers are tracked separately, see has_anymod()
+ */
+uint8_t get_held_keycode_count(void) { return keycode_bitmap_count(held_keycodes); }
@@ -18,7 +18,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "report.h"
+#include "keycode.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,12 +30,39 @@ extern report_keyboard_t *keyboard_report;
 
 void send_keyboard_report(void);
 
+/* keycode bitmap, one bit for each basic keycode */
+#define KEYCODE_BITMAP_WORDS 8
+typedef uint32_t keycode_bitmap_t[KEYCODE_BITMAP_WORDS];
+
+inline bool keycode_bitmap_get(const keycode_bitmap_t bitmap, uint8_t code) { return bitmap[code >> 5] & ((uint32_t)1 << (code & 31)); }
+
+inline void keycode_bitmap_set(keycode_bitmap_t bitmap, uint8_t code) { bitmap[code >> 5] |= (uint32_t)1 << (code & 31); }
+
+inline void keycode_bitmap_clear(keycode_bitmap_t bitmap, uint8_t code) { bitmap[code >> 5] &= ~((uint32_t)1 << (code & 31)); }
+
+bool    keycode_bitmap_any(const keycode_bitmap_t bitmap);
+uint8_t keycode_bitmap_count(const keycode_bitmap_t bitmap);
+
+// Basic keycodes added with add_key() and not yet deleted, whether or not they fit in the report
+extern keycode_bitmap_t held_keycodes;
+
 /* key */
-inline void add_key(uint8_t key) { add_key_to_report(keyboard_report, key); }
+inline void add_key(uint8_t key) {
+    keycode_bitmap_set(held_keycodes, key);
+    add_key_to_report(keyboard_report, key);
+}
 
-inline void del_key(uint8_t key) { del_key_from_report(keyboard_report, key); }
+inline void del_key(uint8_t key) {
+    keycode_bitmap_clear(held_keycodes, key);
+    del_key_from_report(keyboard_report, key);
+}
 
-inline void clear_keys(void) { clear_keys_from_report(keyboard_report); }
+inline void clear_keys(void) {
+    for (uint8_t i = 0; i < KEYCODE_BITMAP_WORDS; i++) {
+        held_keycodes[i] = 0;
+    }
+    clear_keys_from_report(keyboard_report);
+}
 
 /* modifier */
 uint8_t get_mods(void);
@@ -88,6 +117,12 @@ void oneshot_layer_changed_kb(uint8_t layer);
 /* inspect */
 uint8_t has_anymod(void);
 
+inline bool is_keycode_held(uint8_t key) { return key != KC_NO && keycode_bitmap_get(held_keycodes, key); }
+
+bool    has_any_keycode_held(void);
+bool    has_alpha_keycode_held(void);
+uint8_t get_held_keycode_count(void);
+
 #ifdef SWAP_HANDS_ENABLE
 void set_oneshot_swaphands(void);
 void release_oneshot_swaphands(void);
@@ -177,15 +177,28 @@ typedef struct {
     uint16_t usage;
 } __attribute__((packed)) report_extra_t;
 
+#ifdef MOUSE_EXTENDED_REPORT
+#    if defined(PROTOCOL_ARM_ATSAM) || defined(BLUETOOTH_ENABLE)
+#        error "MOUSE_EXTENDED_REPORT is only supported by the LUFA, ChibiOS and V-USB protocols"
+#    endif
+typedef int16_t mouse_xy_report_t;
+#    define MOUSE_REPORT_XY_MIN -32767
+#    define MOUSE_REPORT_XY_MAX 32767
+#else
+typedef int8_t mouse_xy_report_t;
+#    define MOUSE_REPORT_XY_MIN -127
+#    define MOUSE_REPORT_XY_MAX 127
+#endif
+
 typedef struct {
 #ifdef MOUSE_SHARED_EP
     uint8_t report_id;
 #endif
-    uint8_t buttons;
-    int8_t  x;
-    int8_t  y;
-    int8_t  v;
-    int8_t  h;
+    uint8_t           buttons;
+    mouse_xy_report_t x;
+    mouse_xy_report_t y;
+    int8_t            v;
+    int8_t            h;
 } __attribute__((packed)) report_mouse_t;
 
 typedef struct {
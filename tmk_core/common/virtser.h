@@ -1,7 +1,12 @@
 #pragma once
 
+#include <stdint.h>
+
 /* Define this function in your code to process incoming bytes */
 void virtser_recv(const uint8_t ch);
 
 /* Call this to send a character over the Virtual Serial Device */
 void virtser_send(const uint8_t byte);
+
+/* Call this to send several bytes over the Virtual Serial Device in as few transfers as possible */
+void virtser_send_buffer(const uint8_t *data, uint8_t length);
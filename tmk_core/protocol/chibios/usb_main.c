@@ -39,6 +39,7 @@
 #    include "led.h"
 #endif
 #include "wait.h"
+#include "ring_buffer.h"
 #include "usb_descriptor.h"
 #include "usb_driver.h"
 
@@ -370,34 +371,11 @@ static usb_driver_configs_t drivers = {
  */
 
 #define USB_EVENT_QUEUE_SIZE 16
-usbevent_t event_queue[USB_EVENT_QUEUE_SIZE];
-uint8_t    event_queue_head;
-uint8_t    event_queue_tail;
+RING_BUFFER_DEFINE(usb_event_queue, usbevent_t, USB_EVENT_QUEUE_SIZE);
 
 void usb_event_queue_init(void) {
     // Initialise the event queue
-    memset(&event_queue, 0, sizeof(event_queue));
-    event_queue_head = 0;
-    event_queue_tail = 0;
-}
-
-static inline bool usb_event_queue_enqueue(usbevent_t event) {
-    uint8_t next = (event_queue_head + 1) % USB_EVENT_QUEUE_SIZE;
-    if (next == event_queue_tail) {
-        return false;
-    }
-    event_queue[event_queue_head] = event;
-    event_queue_head              = next;
-    return true;
-}
-
-static inline bool usb_event_queue_dequeue(usbevent_t *event) {
-    if (event_queue_head == event_queue_tail) {
-        return false;
-    }
-    *event           = event_queue[event_queue_tail];
-    event_queue_tail = (event_queue_tail + 1) % USB_EVENT_QUEUE_SIZE;
-    return true;
+    usb_event_queue_clear();
 }
 
 static inline void usb_event_suspend_handler(void) {
@@ -1008,6 +986,8 @@ void midi_ep_task(void) {
 
 void virtser_send(const uint8_t byte) { chnWrite(&drivers.serial_driver.driver, &byte, 1); }
 
+void virtser_send_buffer(const uint8_t *data, uint8_t length) { chnWrite(&drivers.serial_driver.driver, data, length); }
+
 __attribute__((weak)) void virtser_recv(uint8_t c) {
     // Ignore by default
 }
@@ -17,6 +17,11 @@ Copyright 2010,2011,2012,2013 Jun WAKO <wakojun@gmail.com>
 
 uint8_t ibm4704_error = 0;
 
+#ifndef RBUF_SIZE
+#    define RBUF_SIZE 32
+#endif
+RING_BUFFER_DEFINE(rbuf, uint8_t, RBUF_SIZE);
+
 void ibm4704_init(void) {
     inhibit();  // keep keyboard from sending
     IBM4704_INT_INIT();
@@ -98,15 +103,17 @@ ERROR:
 
 /* wait forever to receive data */
 uint8_t ibm4704_recv_response(void) {
-    while (!rbuf_has_data()) {
+    uint8_t data;
+    while (!rbuf_dequeue(&data)) {
         _delay_ms(1);
     }
-    return rbuf_dequeue();
+    return data;
 }
 
 uint8_t ibm4704_recv(void) {
-    if (rbuf_has_data()) {
-        return rbuf_dequeue();
+    uint8_t data;
+    if (rbuf_dequeue(&data)) {
+        return data;
     } else {
         return -1;
     }
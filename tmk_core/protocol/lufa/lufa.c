@@ -951,11 +951,11 @@ void virtser_task(void) {
         virtser_recv(ch);
     }
 }
-/** \brief Virtual Serial Send
+/** \brief Virtual Serial Send Buffer
  *
- * FIXME: Needs doc
+ * Writes all bytes to the IN endpoint and flushes once, so they go out together.
  */
-void virtser_send(const uint8_t byte) {
+void virtser_send_buffer(const uint8_t *data, uint8_t length) {
     uint8_t timeout = 255;
     uint8_t ep      = Endpoint_GetCurrentEndpoint();
 
@@ -970,7 +970,7 @@ void virtser_send(const uint8_t byte) {
 
         while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
 
-        Endpoint_Write_8(byte);
+        Endpoint_Write_Stream_LE(data, length, NULL);
         CDC_Device_Flush(&cdc_device);
 
         if (Endpoint_IsINReady()) {
@@ -980,6 +980,12 @@ void virtser_send(const uint8_t byte) {
         Endpoint_SelectEndpoint(ep);
     }
 }
+
+/** \brief Virtual Serial Send
+ *
+ * FIXME: Needs doc
+ */
+void virtser_send(const uint8_t byte) { virtser_send_buffer(&byte, 1); }
 #endif
 
 /*******************************************************************************
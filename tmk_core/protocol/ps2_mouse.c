@@ -30,6 +30,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 static report_mouse_t mouse_report = {};
 
+/* 4 once the mouse has confirmed the IntelliMouse extensions, which add a wheel byte to every packet */
+static uint8_t packet_size = 3;
+
 static inline void ps2_mouse_print_report(report_mouse_t *mouse_report);
 static inline void ps2_mouse_convert_report_to_hid(report_mouse_t *mouse_report);
 static inline void ps2_mouse_clear_report(report_mouse_t *mouse_report);
@@ -38,6 +41,38 @@ static inline void ps2_mouse_scroll_button_task(report_mouse_t *mouse_report);
 
 /* ============================= IMPLEMENTATION ============================ */
 
+#if defined(PS2_USE_INT) || defined(PS2_USE_USART)
+static uint8_t  packet[4];
+static uint8_t  packet_length = 0;
+static uint16_t packet_timer  = 0;
+
+/* Assembles stream mode packets from the bytes the PS/2 interrupt has queued, without waiting for more to arrive.
+ * Returns true when packet[] holds a complete packet.
+ */
+static bool ps2_mouse_receive_packet(void) {
+    if (packet_length && timer_elapsed(packet_timer) > PS2_MOUSE_PACKET_TIMEOUT) {
+        // The rest of this packet got lost, start over with the next one
+        packet_length = 0;
+    }
+    for (;;) {
+        uint8_t data = ps2_host_recv();
+        if (ps2_error == PS2_ERR_NODATA) {
+            return false;
+        }
+        if (packet_length == 0 && !(data & (1 << PS2_MOUSE_ALWAYS_1))) {
+            // Cannot be the first byte of a packet, skip ahead until the stream is in sync again
+            continue;
+        }
+        packet_timer            = timer_read();
+        packet[packet_length++] = data;
+        if (packet_length == packet_size) {
+            packet_length = 0;
+            return true;
+        }
+    }
+}
+#endif
+
 /* supports only 3 button mouse at this time */
 void ps2_mouse_init(void) {
     ps2_host_init();
@@ -49,16 +84,17 @@ void ps2_mouse_init(void) {
     PS2_MOUSE_RECEIVE("ps2_mouse_init: read BAT");
     PS2_MOUSE_RECEIVE("ps2_mouse_init: read DevID");
 
+#ifdef PS2_MOUSE_ENABLE_SCROLLING
+    // before data reporting starts, so no stream packet gets mixed up with the device id
+    ps2_mouse_enable_scrolling();
+#endif
+
 #ifdef PS2_MOUSE_USE_REMOTE_MODE
     ps2_mouse_set_remote_mode();
 #else
     ps2_mouse_enable_data_reporting();
 #endif
 
-#ifdef PS2_MOUSE_ENABLE_SCROLLING
-    ps2_mouse_enable_scrolling();
-#endif
-
 #ifdef PS2_MOUSE_USE_2_1_SCALING
     ps2_mouse_set_scaling_2_1();
 #endif
@@ -75,18 +111,34 @@ void ps2_mouse_task(void) {
     extern int     tp_buttons;
 
     /* receives packet from mouse */
-    uint8_t rcv;
-    rcv = ps2_host_send(PS2_MOUSE_READ_DATA);
-    if (rcv == PS2_ACK) {
-        mouse_report.buttons = ps2_host_recv_response() | tp_buttons;
-        mouse_report.x       = ps2_host_recv_response() * PS2_MOUSE_X_MULTIPLIER;
-        mouse_report.y       = ps2_host_recv_response() * PS2_MOUSE_Y_MULTIPLIER;
-#ifdef PS2_MOUSE_ENABLE_SCROLLING
-        mouse_report.v = -(ps2_host_recv_response() & PS2_MOUSE_SCROLL_MASK) * PS2_MOUSE_V_MULTIPLIER;
+#if defined(PS2_USE_INT) || defined(PS2_USE_USART)
+    if (ps2_mouse_mode == PS2_MOUSE_STREAM_MODE) {
+        // The mouse sends packets on its own, so only take what the interrupt has already received
+        if (!ps2_mouse_receive_packet()) {
+            return;
+        }
+        mouse_report.buttons = packet[0] | tp_buttons;
+        mouse_report.x       = (int8_t)(packet[1] * PS2_MOUSE_X_MULTIPLIER);
+        mouse_report.y       = (int8_t)(packet[2] * PS2_MOUSE_Y_MULTIPLIER);
+        if (packet_size == 4) {
+            mouse_report.v = -(packet[3] & PS2_MOUSE_SCROLL_MASK) * PS2_MOUSE_V_MULTIPLIER;
+        }
+    } else
 #endif
-    } else {
-        if (debug_mouse) print("ps2_mouse: fail to get mouse packet\n");
-        return;
+    {
+        uint8_t rcv;
+        rcv = ps2_host_send(PS2_MOUSE_READ_DATA);
+        if (rcv == PS2_ACK) {
+            mouse_report.buttons = ps2_host_recv_response() | tp_buttons;
+            mouse_report.x       = (int8_t)(ps2_host_recv_response() * PS2_MOUSE_X_MULTIPLIER);
+            mouse_report.y       = (int8_t)(ps2_host_recv_response() * PS2_MOUSE_Y_MULTIPLIER);
+            if (packet_size == 4) {
+                mouse_report.v = -(ps2_host_recv_response() & PS2_MOUSE_SCROLL_MASK) * PS2_MOUSE_V_MULTIPLIER;
+            }
+        } else {
+            if (debug_mouse) print("ps2_mouse: fail to get mouse packet\n");
+            return;
+        }
     }
 
     /* if mouse moves or buttons state changes */
@@ -210,7 +262,10 @@ static inline void ps2_mouse_enable_scrolling(void) {
     PS2_MOUSE_SEND(PS2_MOUSE_SET_SAMPLE_RATE, "Set sample rate");
     PS2_MOUSE_SEND(80, "80");
     PS2_MOUSE_SEND(PS2_MOUSE_GET_DEVICE_ID, "Finished enabling scroll wheel");
-    _delay_ms(20);
+    // 3 is an IntelliMouse, 4 an IntelliMouse Explorer, anything else ignored the sequence and keeps 3 byte packets
+    uint8_t device_id = ps2_host_recv_response();
+    packet_size       = (device_id == 3 || device_id == 4) ? 4 : 3;
+    if (debug_mouse) xprintf("ps2_mouse: device id: %X\n", device_id);
 }
 
 #define PRESS_SCROLL_BUTTONS mouse_report->buttons |= (PS2_MOUSE_SCROLL_BTN_MASK)
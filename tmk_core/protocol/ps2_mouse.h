@@ -74,11 +74,13 @@ __attribute__((unused)) static enum ps2_mouse_mode_e {
  *    0|[Yovflw][Xovflw][Ysign ][Xsign ][ 1    ][Middle][Right ][Left  ]
  *    1|[                    X movement(0-255)                         ]
  *    2|[                    Y movement(0-255)                         ]
+ *    3|[                    Wheel movement, IntelliMouse only         ]
  */
 #define PS2_MOUSE_BTN_MASK 0x07
 #define PS2_MOUSE_BTN_LEFT 0
 #define PS2_MOUSE_BTN_RIGHT 1
 #define PS2_MOUSE_BTN_MIDDLE 2
+#define PS2_MOUSE_ALWAYS_1 3
 #define PS2_MOUSE_X_SIGN 4
 #define PS2_MOUSE_Y_SIGN 5
 #define PS2_MOUSE_X_OVFLW 6
@@ -116,6 +118,10 @@ __attribute__((unused)) static enum ps2_mouse_mode_e {
 #ifndef PS2_MOUSE_INIT_DELAY
 #    define PS2_MOUSE_INIT_DELAY 1000
 #endif
+/* drop a partly received stream mode packet when its next byte takes longer than this(ms) */
+#ifndef PS2_MOUSE_PACKET_TIMEOUT
+#    define PS2_MOUSE_PACKET_TIMEOUT 20
+#endif
 
 enum ps2_mouse_command_e {
     PS2_MOUSE_RESET                  = 0xFF,
@@ -36,7 +36,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #endif
 
 #if defined(CONSOLE_ENABLE)
-#    define RBUF_SIZE 128
 #    include "ring_buffer.h"
 #endif
 
@@ -171,6 +170,11 @@ void raw_hid_task(void) {
 #    define CONSOLE_BUFFER_SIZE 32
 #    define CONSOLE_EPSIZE 8
 
+#    ifndef RBUF_SIZE
+#        define RBUF_SIZE 128
+#    endif
+RING_BUFFER_DEFINE(rbuf, uint8_t, RBUF_SIZE);
+
 int8_t sendchar(uint8_t c) {
     rbuf_enqueue(c);
     return 0;
@@ -202,7 +206,7 @@ void console_task(void) {
     char    send_buf[CONSOLE_BUFFER_SIZE] = {0};
     uint8_t send_buf_count                = 0;
     while (rbuf_has_data() && send_buf_count < CONSOLE_EPSIZE) {
-        send_buf[send_buf_count++] = rbuf_dequeue();
+        rbuf_dequeue((uint8_t *)&send_buf[send_buf_count++]);
     }
 
     char *temp = send_buf;
@@ -454,6 +458,17 @@ const PROGMEM uchar shared_hid_report[] = {
     0x75, 0x01,  //     Report Size (1)
     0x81, 0x02,  //     Input (Data, Variable, Absolute)
 
+#    ifdef MOUSE_EXTENDED_REPORT
+    // X/Y position (4 bytes)
+    0x05, 0x01,        //     Usage Page (Generic Desktop)
+    0x09, 0x30,        //     Usage (X)
+    0x09, 0x31,        //     Usage (Y)
+    0x16, 0x01, 0x80,  //     Logical Minimum (-32767)
+    0x26, 0xFF, 0x7F,  //     Logical Maximum (32767)
+    0x95, 0x02,        //     Report Count (2)
+    0x75, 0x10,        //     Report Size (16)
+    0x81, 0x06,        //     Input (Data, Variable, Relative)
+#    else
     // X/Y position (2 bytes)
     0x05, 0x01,  //     Usage Page (Generic Desktop)
     0x09, 0x30,  //     Usage (X)
@@ -463,6 +478,7 @@ const PROGMEM uchar shared_hid_report[] = {
     0x95, 0x02,  //     Report Count (2)
     0x75, 0x08,  //     Report Size (8)
     0x81, 0x06,  //     Input (Data, Variable, Relative)
+#    endif
 
     // Vertical wheel (1 byte)
     0x09, 0x38,  //     Usage (Wheel)
@@ -41,11 +41,13 @@ POSSIBILITY OF SUCH DAMAGE.
 #include "xt.h"
 #include "wait.h"
 #include "debug.h"
+#include "ring_buffer.h"
 
-static inline uint8_t pbuf_dequeue(void);
-static inline void    pbuf_enqueue(uint8_t data);
-static inline bool    pbuf_has_data(void);
-static inline void    pbuf_clear(void);
+/*--------------------------------------------------------------------
+ * Ring buffer to store scan codes from keyboard
+ *------------------------------------------------------------------*/
+#define PBUF_SIZE 32
+RING_BUFFER_DEFINE(pbuf, uint8_t, PBUF_SIZE);
 
 void xt_host_init(void) {
     XT_INT_INIT();
@@ -70,11 +72,9 @@ void xt_host_init(void) {
 
 /* get data received by interrupt */
 uint8_t xt_host_recv(void) {
-    if (pbuf_has_data()) {
-        return pbuf_dequeue();
-    } else {
-        return 0;
-    }
+    uint8_t data = 0;
+    pbuf_dequeue(&data);
+    return data;
 }
 
 ISR(XT_INT_VECT) {
@@ -108,59 +108,11 @@ ISR(XT_INT_VECT) {
             break;
     }
     if (state++ == BIT7) {
-        pbuf_enqueue(data);
+        if (!pbuf_enqueue(data)) {
+            dprintf("pbuf: full\n");
+        }
         state = START;
         data  = 0;
     }
     return;
 }
-
-/*--------------------------------------------------------------------
- * Ring buffer to store scan codes from keyboard
- *------------------------------------------------------------------*/
-#define PBUF_SIZE 32
-static uint8_t pbuf[PBUF_SIZE];
-static uint8_t pbuf_head = 0;
-static uint8_t pbuf_tail = 0;
-
-static inline void pbuf_enqueue(uint8_t data) {
-    uint8_t sreg = SREG;
-    cli();
-    uint8_t next = (pbuf_head + 1) % PBUF_SIZE;
-    if (next != pbuf_tail) {
-        pbuf[pbuf_head] = data;
-        pbuf_head       = next;
-    } else {
-        dprintf("pbuf: full\n");
-    }
-    SREG = sreg;
-}
-
-static inline uint8_t pbuf_dequeue(void) {
-    uint8_t val = 0;
-
-    uint8_t sreg = SREG;
-    cli();
-    if (pbuf_head != pbuf_tail) {
-        val       = pbuf[pbuf_tail];
-        pbuf_tail = (pbuf_tail + 1) % PBUF_SIZE;
-    }
-    SREG = sreg;
-
-    return val;
-}
-
-static inline bool pbuf_has_data(void) {
-    uint8_t sreg = SREG;
-    cli();
-    bool has_data = (pbuf_head != pbuf_tail);
-    SREG          = sreg;
-    return has_data;
-}
-
-static inline void pbuf_clear(void) {
-    uint8_t sreg = SREG;
-    cli();
-    pbuf_head = pbuf_tail = 0;
-    SREG                  = sreg;
-}